@@ -0,0 +1,100 @@
+#pragma once
+/**
+ * Thin hardware abstraction for time, GPIO, UART and the real time clock.
+ *
+ * The menu calls these instead of the core functions, so it builds on 
+ * every env in platformio.ini. Each board gets the fastest primitive it 
+ * has: OutputPin writes the port registers of the AVR, GPOS/GPOC of the 
+ * ESP8266 and GPIO.out_w1ts/out_w1tc of the ESP32. The uno has no RTC, 
+ * there the clock is kept in software from millis().
+ *
+ * Without ARDUINO the layer runs on the host of the native env: the pins
+ * are levels kept in hostPins, the UART is stdin and stdout and the clock
+ * is kept in software like on the uno.
+ */
+#include <Arduino.h>
+#include <time.h>
+#if defined(ESP32)
+#include <soc/gpio_struct.h>
+#endif
+
+#if ! defined(ARDUINO)
+#define BOARD_HOST 1
+constexpr uint8_t HOST_PINS = 40;
+extern bool hostPins[HOST_PINS];   // written by OutputPin, read by gpioRead()
+#endif
+
+// Time since start
+inline uint32_t timeMs() { return millis(); }
+inline uint32_t timeUs() { return micros(); }
+
+/**
+ * A digital output, written without the pin lookups of digitalWrite()
+ */
+class OutputPin
+{
+  public:
+    void begin(uint8_t pin);
+
+    void write(bool high)
+    {
+#if defined(__AVR__)
+      uint8_t sreg = SREG;  // the port may be shared with pins written by interrupts
+      cli();
+      if (high) *port |= mask;
+      else      *port &= ~mask;
+      SREG = sreg;
+#elif defined(ESP8266)
+      if (pin == 16) GP16O = high;
+      else if (high) GPOS = mask;
+      else           GPOC = mask;
+#elif defined(BOARD_HOST)
+      hostPins[pin % HOST_PINS] = high;
+#else
+      if (pin < 32)
+      {
+        if (high) GPIO.out_w1ts = mask;
+        else      GPIO.out_w1tc = mask;
+      }
+      else
+      {
+        if (high) GPIO.out1_w1ts.val = mask;
+        else      GPIO.out1_w1tc.val = mask;
+      }
+#endif
+    }
+
+  private:
+#if defined(__AVR__)
+    volatile uint8_t* port;
+    uint8_t           mask;
+#else
+    uint8_t           pin;
+    uint32_t          mask;
+#endif
+};
+
+/**
+ * Level of a digital input, read from the input register
+ */
+inline bool gpioRead(uint8_t pin)
+{
+#if defined(__AVR__)
+  return *portInputRegister(digitalPinToPort(pin)) & digitalPinToBitMask(pin);
+#elif defined(ESP8266)
+  return pin == 16 ? GP16I & 1 : GPI >> pin & 1;
+#elif defined(BOARD_HOST)
+  return hostPins[pin % HOST_PINS];
+#else
+  return pin < 32 ? GPIO.in >> pin & 1 : GPIO.in1.val >> (pin - 32) & 1;
+#endif
+}
+
+// The UART of the serial session
+Stream& uartBegin(uint32_t baud);
+void    uartBaud(uint32_t baud);
+bool    uartHardwareFlow(int8_t cts, int8_t rts);
+
+// Real time clock, rtcGet() is false while the clock was never set
+bool    rtcGet(tm& time);
+void    rtcSet(tm& time);
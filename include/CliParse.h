@@ -0,0 +1,20 @@
+#pragma once
+/**
+ * Parsers for the values entered on the command line.
+ *
+ * They depend only on the C library, so the same code runs on the boards and
+ * on a host. Every parser rejects empty input, trailing garbage and values
+ * out of range and leaves the result untouched when it returns false.
+ */
+#include <stdint.h>
+#include <time.h>
+
+// Years a date may have. The boards read a clock before DATE_MIN_YEAR as 
+// never set, the time_t of the AVR starts in 2000 and a 32 bit one ends in 2038.
+constexpr int DATE_MIN_YEAR = 2020;
+constexpr int DATE_MAX_YEAR = 2037;
+
+bool parseInteger(const char* str, int32_t& value);
+bool parseFloat(const char* str, double& value);
+bool parseDateTime(const char* str, tm& time);
+bool parseRange(const char* str, uint32_t& start, uint32_t& length);
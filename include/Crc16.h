@@ -0,0 +1,10 @@
+#pragma once
+/**
+ * CRC-16/XMODEM (polynomial 0x1021, initial value 0), as used by XMODEM,
+ * YMODEM and the telemetry frames. Pass the previous result as crc to
+ * continue over several buffers.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+uint16_t crc16(const uint8_t* data, size_t size, uint16_t crc = 0);
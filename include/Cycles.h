@@ -0,0 +1,39 @@
+#pragma once
+/**
+ * CPU cycle counter for timing short pieces of code on the board.
+ *
+ * On ESP32 and ESP8266 the Xtensa register CCOUNT counts every cycle. 
+ * The AVR has no such register, there Timer1 runs without prescaler and 
+ * its overflows extend it to 32 bits. cyclesBegin() takes Timer1 over, 
+ * which stops PWM on pins 9 and 10, cyclesEnd() gives it back.
+ */
+#include <Print.h>
+#include <stdint.h>
+
+void     cyclesBegin();
+void     cyclesEnd();
+uint32_t cycles();
+uint16_t cyclesPerMicro();
+
+/**
+ * Swallows everything, to time formatting without the transport
+ */
+class NullPrint : public Print
+{
+  public:
+    size_t write(uint8_t c) override { return 1; }
+    size_t write(const uint8_t* buf, size_t size) override { return size; }
+    using Print::write;
+};
+
+/**
+ * Mean cycles of one call of fn, taken over runs calls
+ */
+template<typename F>
+uint32_t measureCycles(uint16_t runs, F fn)
+{
+  uint32_t start = cycles();
+
+  for (uint16_t i = 0; i < runs; i++) fn();
+  return (cycles() - start) / runs;
+}
@@ -0,0 +1,34 @@
+#pragma once
+/**
+ * Menu actions triggered by edges on GPIO pins.
+ *
+ * The interrupt handler only stores the binding and the time of the edge 
+ * in a lock-free queue, the main loop takes the events and dispatches the
+ * bound action. The latency from the edge to the start of the action is 
+ * kept as a statistic. edgeInject() simulates an edge from software.
+ */
+#include <stdint.h>
+
+constexpr uint8_t EDGE_BINDINGS = 4;   // pins that can be bound at most
+constexpr uint8_t EDGE_QUEUE    = 8;   // a power of 2
+
+struct EdgeEvent
+{
+  uint8_t  binding;   // index of the binding
+  uint32_t micros;    // time of the edge
+};
+
+struct EdgeStats
+{
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint32_t total;
+  uint32_t overflows; // edges lost because the queue was full
+};
+
+void             edgeAttach(uint8_t binding, uint8_t pin, int mode);
+void             edgeInject(uint8_t binding);
+bool             edgePop(EdgeEvent& event);
+void             edgeLatency(uint32_t us);
+const EdgeStats& edgeStats();
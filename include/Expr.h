@@ -0,0 +1,25 @@
+#pragma once
+/**
+ * Arithmetic expressions for numeric input, e.g. 0x40 << 2 or (i + 3) * 2
+ *
+ * Operators by increasing precedence: << >>, + -, * / %, unary - +.
+ * Parentheses group. Numbers are decimal or hexadecimal with 0x, floats 
+ * are accepted by the double version only, which also rejects % << >>.
+ * Names are resolved by the lookup function given, which returns the value
+ * in the type of the result, so an integer variable keeps all its 32 bits
+ * also where a double is a 32-bit float, as on the AVR.
+ *
+ * The expression is evaluated by the shunting-yard algorithm on two fixed
+ * stacks while it is scanned, nothing is allocated.
+ */
+#include <stdint.h>
+
+constexpr uint8_t EXPR_DEPTH = 16;  // operands and operators pending at most
+
+template<typename T>
+using Lookup    = bool(*)(const char* name, uint8_t len, T& value);
+using IntLookup = Lookup<int32_t>;
+using VarLookup = Lookup<double>;
+
+bool evaluate(const char* expr, int32_t& result, IntLookup lookup = nullptr);
+bool evaluate(const char* expr, double& result, VarLookup lookup = nullptr);
@@ -0,0 +1,165 @@
+#pragma once
+/**
+ * Type safe output without format strings.
+ *
+ *   emit(out, value, " was entered ");
+ *   emit(out, width(key, 3), fixed(volts, 2), repeat(' ', 80));
+ *
+ * The compiler chooses the conversion of every argument from its type, so
+ * there is no format string to be parsed at run time, no argument that can
+ * mismatch its conversion and no need to link vfprintf. Each argument
+ * becomes a direct call of the matching Print::print() overload, only 
+ * fixed() formats its digits itself.
+ */
+#include <Print.h>
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * Collects printed text in a buffer, truncating what doesn't fit
+ */
+class BufferPrint : public Print
+{
+  public:
+    BufferPrint(char* buf, size_t size) : buf(buf), size(size) { buf[0] = '\0'; }
+
+    size_t write(uint8_t c) override
+    {
+      if (len + 1 >= size) return 0;
+      buf[len++] = c;
+      buf[len]   = '\0';
+      return 1;
+    }
+    using Print::write;
+
+    void        clear() { len = 0; buf[0] = '\0'; }
+    const char* c_str() const { return buf; }
+    size_t      length() const { return len; }
+
+  private:
+    char*  buf;
+    size_t size;
+    size_t len = 0;
+};
+
+// A float with a fixed number of decimals
+struct Fixed  { double value; uint8_t decimals; };
+// An unsigned number in hexadecimal with at least digits digits, 8 at most
+struct Hex    { uint32_t value; uint8_t digits; };
+// A character repeated count times
+struct Repeat { char c; uint8_t count; };
+// Any value right aligned in a field of the given width, a sign precedes zero fill
+template<typename T> 
+struct Width  { const T& value; uint8_t width; char fill; };
+
+inline Fixed  fixed(double value, uint8_t decimals) { return Fixed{ value, decimals }; }
+inline Hex    hex(uint32_t value, uint8_t digits = 1) { return Hex{ value, digits }; }
+inline Repeat repeat(char c, uint8_t count) { return Repeat{ c, count }; }
+template<typename T> 
+inline Width<T> width(const T& value, uint8_t width, char fill = ' ') { return Width<T>{ value, width, fill }; }
+
+
+template<typename T>
+inline size_t emitOne(Print& out, const T& value) { return out.print(value); }
+
+/**
+ * Print::print(double) of the cores shows "ovf" beyond the range of a 
+ * uint32_t, so the digits are made here. Such values are shown with an
+ * exponent, e.g. 1.50e10, which is a valid JSON number as well.
+ */
+inline size_t emitOne(Print& out, const Fixed& f)
+{
+  double  v        = f.value;
+  uint8_t decimals = f.decimals < 9 ? f.decimals : 9;  // the fraction is a uint32_t
+  double  scale    = 1;
+  int16_t exponent = 0;
+  size_t  n        = 0;
+
+  if (isnan(v)) return out.print("nan");
+  if (isinf(v)) return out.print(v < 0 ? "-inf" : "inf");
+  if (v < 0)
+  {
+    n += out.write('-');
+    v = -v;
+  }
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+
+  double rounded = v + 0.5 / scale;
+  if (rounded >= 4294967296.0)
+  {
+    while (v >= 10)
+    {
+      v /= 10;
+      exponent++;
+    }
+    rounded = v + 0.5 / scale;
+    if (rounded >= 10)  // 9.999 rounded up
+    {
+      v /= 10;
+      exponent++;
+      rounded = v + 0.5 / scale;
+    }
+  }
+
+  uint32_t whole    = (uint32_t)rounded;
+  uint32_t fraction = (uint32_t)((rounded - whole) * scale);
+
+  n += out.print((unsigned long)whole);
+  if (decimals > 0)
+  {
+    char digits[9];
+    for (uint8_t i = decimals; i > 0; i--, fraction /= 10) digits[i - 1] = '0' + fraction % 10;
+    n += out.write('.');
+    n += out.write((const uint8_t*)digits, decimals);
+  }
+  if (exponent) n += out.write('e') + out.print((int)exponent);
+  return n;
+}
+
+// A plain float gets the 2 decimals Print::print() would give it
+inline size_t emitOne(Print& out, double value) { return emitOne(out, fixed(value, 2)); }
+inline size_t emitOne(Print& out, float value)  { return emitOne(out, fixed(value, 2)); }
+
+inline size_t emitOne(Print& out, const Repeat& r)
+{
+  for (uint8_t i = 0; i < r.count; i++) out.write(r.c);
+  return r.count;
+}
+
+inline size_t emitOne(Print& out, const Hex& h)
+{
+  static const char digit[] = "0123456789ABCDEF";
+  char    buf[8];
+  uint8_t n = 0;
+  uint8_t digits = h.digits < sizeof(buf) ? h.digits : sizeof(buf);  // a uint32_t has no more
+  
+  for (uint32_t v = h.value; v || n < digits; v >>= 4) buf[n++] = digit[v & 15];
+  for (uint8_t i = n; i > 0; i--) out.write(buf[i - 1]);
+  return n;
+}
+
+template<typename T>
+inline size_t emitOne(Print& out, const Width<T>& w)
+{
+  char        buf[32];
+  BufferPrint field(buf, sizeof(buf));
+
+  emitOne(field, w.value);
+  size_t      pad  = w.width > field.length() ? w.width - field.length() : 0;
+  const char* text = field.c_str();
+  size_t      n    = 0;
+
+  if (w.fill == '0' && *text == '-') n += out.write(*text++);  // the sign goes before the zeros
+  n += emitOne(out, repeat(w.fill, pad));
+  return n + out.print(text);
+}
+
+
+inline size_t emit(Print& out) { return 0; }
+
+template<typename T, typename... Rest>
+inline size_t emit(Print& out, const T& first, const Rest&... rest)
+{
+  size_t n = emitOne(out, first);
+  return n + emit(out, rest...);
+}
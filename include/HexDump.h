@@ -0,0 +1,46 @@
+#pragma once
+/**
+ * Hex dump of RAM or flash, streamed in chunks.
+ *
+ * Each poll() formats at most DUMP_CHUNK rows and only as many as the 
+ * output takes without blocking, then returns to the main loop. Dumping 
+ * a large range thus never stalls the loop nor starves the watchdog.
+ * Rows are aligned to DUMP_ROW bytes, bytes outside the range are blank.
+ * A range is dumped only if it lies within memory that can be read: RAM,
+ * ROM or the flash chip. Reads of other addresses would fault or, like 
+ * the I/O registers of the AVR, have side effects.
+ */
+#include <Arduino.h>
+
+#if defined(__AVR__)
+constexpr uint8_t DUMP_ROW    = 8;     // bytes per row
+constexpr uint8_t DUMP_DIGITS = 4;     // hex digits of the address
+#else
+constexpr uint8_t DUMP_ROW    = 16;
+constexpr uint8_t DUMP_DIGITS = 8;
+#endif
+constexpr uint8_t DUMP_CHUNK  = 4;     // rows per poll
+// address, 3 per byte, 1 before each half, "  |", ascii, "|" CR LF
+constexpr uint8_t DUMP_LINE   = DUMP_DIGITS + 3 * DUMP_ROW + 2 + 3 + DUMP_ROW + 3;
+
+class HexDump
+{
+  public:
+    enum Source : uint8_t { Ram, Flash };
+
+    bool start(Print* out, Source source, uint32_t from, uint32_t length);
+    void stop() { out = nullptr; }
+    bool active() const { return out != nullptr; }
+    void poll();
+
+  private:
+    static bool readable(Source source, uint32_t first, uint32_t last);
+    bool fetch(uint8_t* data, uint32_t row);
+    void format(Print& line, const uint8_t* data, uint32_t row);
+
+    Print*   out = nullptr;
+    Source   source = Ram;
+    uint32_t row = 0;       // address of the next row
+    uint32_t first = 0;     // first and last address of the range
+    uint32_t last = 0;
+};
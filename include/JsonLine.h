@@ -0,0 +1,44 @@
+#pragma once
+/**
+ * JSON lines for machine clients.
+ *
+ * A request is one line like {"cmd":"f","arg":3.14}. JsonTokenizer splits 
+ * the line in place: strings are unescaped and every value is terminated 
+ * within the line itself, so nothing is allocated and no document tree is 
+ * built. Replies are written directly to the output as the action runs.
+ */
+#include <Print.h>
+#include <stdint.h>
+
+enum class JsonToken : uint8_t 
+{ 
+  End, Error, BeginObject, EndObject, Colon, Comma, String, Number, Literal 
+};
+
+class JsonTokenizer
+{
+  public:
+    explicit JsonTokenizer(char* text) : p(text) {}
+
+    JsonToken   next();
+    const char* value() const { return val; } // text of a String, Number or Literal
+
+  private:
+    JsonToken string();
+    JsonToken scalar(JsonToken type);
+
+    char* p;              // next character to look at
+    char* val = nullptr;
+    char  held = 0;       // character at p overwritten by the terminator of a scalar
+};
+
+// Typed result of an action, reported as "value" of the reply. Failed 
+// marks input the action rejected.
+struct JsonResult
+{
+  enum : uint8_t { None, Failed, Integer, Float, Bool } type = None;
+  union { int32_t i; double f; bool b; };
+};
+
+bool parseJsonRequest(char* line, char& cmd, const char*& arg);
+void printJsonValue(Print& out, const JsonResult& result);
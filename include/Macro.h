@@ -0,0 +1,39 @@
+#pragma once
+/**
+ * Recording and playback of command keys and entered lines.
+ *
+ * A macro is stored as a byte sequence: a command key as is, an entered 
+ * line as LINE_MARK followed by the text and a terminating 0. It is kept 
+ * in EEPROM (emulated in flash on ESP32 and ESP8266) and survives a reset.
+ */
+#include <stdint.h>
+
+#if defined(__AVR__)
+constexpr uint8_t MACRO_SIZE = 64;
+#else
+constexpr uint8_t MACRO_SIZE = 250;
+#endif
+constexpr uint8_t LINE_MARK = 0x01;
+
+class Macro
+{
+  public:
+    void start();
+    bool stop();
+    bool recording() const { return rec; }
+    void key(char k);
+    void line(const char* text);
+    bool load();
+
+    uint8_t        size() const { return len; }
+    const uint8_t* data() const { return buf; }
+
+  private:
+    void append(const uint8_t* bytes, uint8_t n);
+    void save();
+
+    uint8_t buf[MACRO_SIZE] = {};
+    uint8_t len = 0;
+    bool    rec = false;
+    bool    overflow = false;
+};
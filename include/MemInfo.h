@@ -0,0 +1,23 @@
+#pragma once
+/**
+ * Heap and stack figures of the running board and a small trace buffer
+ * holding the most recent samples together with the last command key.
+ */
+#include <stdint.h>
+
+struct MemSample
+{
+  uint32_t ms;            // time of the sample
+  char     key;           // last command dispatched before the sample
+  uint32_t freeHeap;      // bytes of free heap in total
+  uint32_t largestBlock;  // largest block that can be allocated
+  uint32_t minFreeHeap;   // lowest free heap seen since start
+  uint32_t stackFree;     // headroom of the loop stack
+  uint8_t  fragmentation; // 100 - largestBlock * 100 / freeHeap
+};
+
+constexpr uint8_t MEM_TRACE_SIZE = 8;
+
+void memSample(MemSample& s, char key);
+void memTrace(const MemSample& s);
+bool memTraceAt(uint8_t age, MemSample& s);
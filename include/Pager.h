@@ -0,0 +1,77 @@
+#pragma once
+/**
+ * Shows a long list one page at a time.
+ *
+ * The list is given by two functions, one returning the number of lines 
+ * and one printing a single line. Only the lines of the current page are 
+ * ever produced, so a list can be generated on the fly and have thousands
+ * of entries.
+ *
+ * A filter restricts the pages to the lines containing a text. The matches
+ * are kept as a bitset, and when the text grows by a keystroke only the 
+ * lines that matched before are tested again.
+ */
+#include <Print.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+constexpr uint8_t  PAGE_LINES   = 10;
+constexpr uint16_t FILTER_LINES = 64;   // longest list that can be filtered
+#else
+constexpr uint8_t  PAGE_LINES   = 20;
+constexpr uint16_t FILTER_LINES = 5000;
+#endif
+constexpr uint8_t  FILTER_SIZE  = 32;
+
+using LineCount = uint16_t(*)();
+using PrintLine = void(*)(Print& out, uint16_t index);
+
+class Pager
+{
+  public:
+    void     open(LineCount count, PrintLine line);
+    void     show(Print& out) const;
+    bool     active() const { return count != nullptr; }
+    uint16_t page() const { return current; }
+    uint16_t pages() const;
+    bool     jump(uint16_t page);
+    bool     next() { return jump(current + 1); }
+    bool     previous() { return current > 0 && jump(current - 1); }
+
+    bool     filter(const char* text);
+    void     clearFilter();
+    bool     filtered() const { return query[0] != '\0'; }
+    uint16_t size() const;
+
+  private:
+    bool     matches(uint16_t i) const { return bits[i / 8] & (1 << (i % 8)); }
+    bool     contains(uint16_t i, const char* text) const;
+
+    LineCount count = nullptr;
+    PrintLine line = nullptr;
+    uint16_t  current = 0;
+    char      query[FILTER_SIZE] = "";            // text of the active filter
+    uint16_t  hits = 0;                           // number of matching lines
+    uint8_t   bits[(FILTER_LINES + 7) / 8];       // bit i set if line i matches
+};
+
+/**
+ * Takes the place of the pager in a profile without lists
+ */
+class NoPager
+{
+  public:
+    void     open(LineCount, PrintLine) {}
+    void     show(Print&) const {}
+    bool     active() const { return false; }
+    uint16_t page() const { return 0; }
+    uint16_t pages() const { return 0; }
+    bool     jump(uint16_t) { return false; }
+    bool     next() { return false; }
+    bool     previous() { return false; }
+
+    bool     filter(const char*) { return false; }
+    void     clearFilter() {}
+    bool     filtered() const { return false; }
+    uint16_t size() const { return 0; }
+};
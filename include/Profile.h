@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * Compile-time feature profiles.
+ *
+ * CLI_PROFILE, set per env in platformio.ini, selects the subsystems built
+ * into the menu. The flags below are constexpr: a menuitem of a subsystem
+ * left out is removed from the menu table at compile time, the code that
+ * serves the subsystem sits in discarded if constexpr branches, so the 
+ * linker drops its actions and data.
+ *
+ *   minimal   menu, input of values, date and time, heartbeat, baud rate
+ *   standard  + telnet, JSON, pager and filter, status line, macros, 
+ *               diagnostics (stack, memory, hex dump, benchmark), GPIO edges,
+ *               YMODEM
+ *   full      + full screen mode, binary telemetry
+ *
+ * State a subsystem keeps in every session is selected by Feature<>, which
+ * gives the stand-in type without the memory where the feature is left out.
+ */
+#include <stdint.h>
+
+#define CLI_MINIMAL  0
+#define CLI_STANDARD 1
+#define CLI_FULL     2
+
+#ifndef CLI_PROFILE
+#if defined(__AVR__)
+#define CLI_PROFILE CLI_MINIMAL
+#elif defined(ESP8266)
+#define CLI_PROFILE CLI_STANDARD
+#else
+#define CLI_PROFILE CLI_FULL
+#endif
+#endif
+
+enum Profile : uint8_t { Minimal = CLI_MINIMAL, Standard = CLI_STANDARD, Full = CLI_FULL };
+
+constexpr Profile PROFILE = (Profile)CLI_PROFILE;
+
+constexpr bool FEATURE_TELNET      = PROFILE >= Standard;
+constexpr bool FEATURE_JSON        = PROFILE >= Standard;
+constexpr bool FEATURE_LISTS       = PROFILE >= Standard;
+constexpr bool FEATURE_STATUS      = PROFILE >= Standard;
+constexpr bool FEATURE_MACROS      = PROFILE >= Standard;
+constexpr bool FEATURE_DIAGNOSTICS = PROFILE >= Standard;
+constexpr bool FEATURE_EDGES       = PROFILE >= Standard;
+constexpr bool FEATURE_FULL_SCREEN = PROFILE >= Full;
+constexpr bool FEATURE_TELEMETRY   = PROFILE >= Full;
+constexpr bool FEATURE_YMODEM      = PROFILE >= Standard;
+
+// On the type if a feature is built in, else Off; std::conditional is missing on the AVR
+template<bool Enabled, typename On, typename Off>
+struct SelectFeature { using Type = On; };
+
+template<typename On, typename Off>
+struct SelectFeature<false, On, Off> { using Type = Off; };
+
+template<bool Enabled, typename On, typename Off>
+using Feature = typename SelectFeature<Enabled, On, Off>::Type;
@@ -0,0 +1,79 @@
+#pragma once
+/**
+ * Full screen text user interface for ANSI terminals.
+ *
+ * Screen keeps what the terminal shows (front) and what it should show 
+ * (back). Drawing only changes the back buffer, flush() sends the cells 
+ * that differ and moves the cursor only where rewriting a few unchanged 
+ * cells would cost more. A refresh therefore costs bytes in proportion to
+ * the change, not to the size of the screen.
+ *
+ * Region prints into a rectangle of the back buffer, LogPane collects 
+ * printed text as a scrolling log to be drawn into a region.
+ */
+#include <Print.h>
+#include <stdint.h>
+
+constexpr uint8_t SCREEN_ROWS = 24;
+constexpr uint8_t SCREEN_COLS = 80;
+
+class Screen
+{
+  public:
+    void begin(Print& out);
+    void end(Print& out);
+    void clear();
+    void put(uint8_t row, uint8_t col, char c);
+    void flush(Print& out, uint8_t cursorRow, uint8_t cursorCol);
+
+  private:
+    void moveTo(Print& out, uint8_t row, uint8_t col);
+
+    char    front[SCREEN_ROWS][SCREEN_COLS] = {};
+    char    back[SCREEN_ROWS][SCREEN_COLS] = {};
+    uint8_t curRow = 0;                 // cursor of the terminal, 0xFF if unknown
+    uint8_t curCol = 0;
+};
+
+
+/**
+ * Prints into a rectangle of the screen, clipping what doesn't fit
+ */
+class Region : public Print
+{
+  public:
+    Region(Screen& screen, uint8_t row, uint8_t col, uint8_t rows, uint8_t cols)
+      : screen(screen), top(row), left(col), rows(rows), cols(cols) {}
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+  private:
+    Screen& screen;
+    uint8_t top, left, rows, cols;
+    uint8_t row = 0, col = 0;
+};
+
+
+constexpr uint8_t LOG_ROWS = 22;
+constexpr uint8_t LOG_COLS = 39;
+
+/**
+ * Keeps the last LOG_ROWS lines printed to it. Lines are cut at LOG_COLS,
+ * carriage return and backspace move within the line and escape sequences
+ * are dropped, so terminal output of the actions can be shown as is.
+ */
+class LogPane : public Print
+{
+  public:
+    void   clear();
+    size_t write(uint8_t c) override;
+    using  Print::write;
+    void   draw(Print& out) const;
+
+  private:
+    char    lines[LOG_ROWS][LOG_COLS + 1];
+    uint8_t last = 0;                   // line being written
+    uint8_t col = 0;
+    uint8_t esc = 0;                    // skipping an escape sequence
+};
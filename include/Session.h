@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * A user of the menu on one transport.
+ *
+ * Each session has its own line buffer with echo, editing and history, its
+ * own pending input and its own output queue. Several sessions are served 
+ * side by side: the main loop calls step() and pump() of every session in 
+ * turn, so no session can block the others while a value is being typed 
+ * or a long output is being sent.
+ *
+ * With software flow control the session stops sending its output queue 
+ * when the peer sends XOFF and resumes on XON. It sends XOFF itself when 
+ * the receive buffer of the transport fills up and XON once it is read.
+ *
+ * In JSON mode the input is not echoed and the output can be escaped for
+ * use inside a JSON string. The output can also be redirected, e.g. into 
+ * a pane of the full screen mode.
+ */
+#include <Arduino.h>
+#include "Pager.h"
+#include "Profile.h"
+#include "StatusLine.h"
+
+#if defined(__AVR__)
+constexpr uint8_t  LINE_SIZE    = 32;
+constexpr uint8_t  HISTORY_SIZE = 2;
+constexpr uint16_t OUT_SIZE     = 64;
+constexpr uint8_t  RX_HIGH      = 48;  // bytes waiting in the receive buffer that cause XOFF
+#else
+constexpr uint8_t  LINE_SIZE    = 128;
+constexpr uint8_t  HISTORY_SIZE = 4;
+constexpr uint16_t OUT_SIZE     = 512;
+constexpr uint8_t  RX_HIGH      = 192;
+#endif
+constexpr uint8_t  RX_LOW       = 16;  // bytes below which XON is sent
+constexpr uint16_t XOFF_TIMEOUT = 3000; // ms a blocking write waits for XON
+
+// Receives the line entered after a call to Session::ask()
+using LineHandler = void(*)(const char* line);
+
+class Session : public Stream
+{
+  public:
+    void    attach(Stream* io);
+    void    detach();
+    bool    active() const { return io != nullptr; }
+    Stream* transport() const { return io; }
+    bool    asking() const { return pending != nullptr; }
+    void    setFlowControl(bool on);
+    bool    flowControl() const { return xonxoff; }
+
+    void    ask(const char* prompt, LineHandler handler, LineHandler edited = nullptr);
+    void    answer(const char* line);
+    void    cancel();
+    void    setJson(bool on) { json = on; }
+    bool    jsonMode() const { return json; }
+    void    setEscape(bool on) { escape = on; }
+    void    redirect(Print* sink) { this->sink = sink; }
+    void    setTap(LineHandler tap) { this->tap = tap; }
+    int     step();
+    void    pump();
+
+    int     available() override;
+    int     read() override;
+    int     peek() override;
+    size_t  write(uint8_t c) override;
+    size_t  write(const uint8_t* buf, size_t size) override;
+    int     availableForWrite() override;
+    void    flush() override;
+    using   Print::write;
+
+    Feature<FEATURE_LISTS, Pager, NoPager>            pager;   // long list being shown
+    Feature<FEATURE_STATUS, StatusLine, NoStatusLine> status;  // status line on the terminal
+
+  private:
+    bool    input(char c);
+    void    recall(int8_t step);
+    void    erase();
+    void    notify();
+    void    drain();
+    size_t  contiguous() const;
+    void    queue(const uint8_t* buf, size_t size);
+    bool    flowChar(int c);
+    void    waitForXon();
+    void    throttle();
+
+    Stream*     io = nullptr;
+    LineHandler pending = nullptr;
+    LineHandler edited = nullptr;             // called with the partial line after each edit
+    LineHandler tap = nullptr;                // sees every line handed over, e.g. to record it
+    char        line[LINE_SIZE];
+    uint8_t     len = 0;
+    uint8_t     esc = 0;                      // progress of an ESC [ x sequence
+    char        history[HISTORY_SIZE][LINE_SIZE];
+    uint8_t     historyNext = 0;              // slot for the next entered line
+    uint8_t     historyCount = 0;
+    uint8_t     historyPos = 0;               // 0 = editing, n = n-th recent line
+    uint8_t     out[OUT_SIZE];
+    uint16_t    outHead = 0;                  // oldest queued byte
+    uint16_t    outCount = 0;
+    bool        xonxoff = false;              // software flow control enabled
+    bool        txPaused = false;             // peer sent XOFF
+    bool        rxPaused = false;             // we sent XOFF
+    bool        json = false;                 // JSON mode, no echo
+    bool        escape = false;               // output is escaped as JSON string content
+    Print*      sink = nullptr;               // takes the output instead of the transport
+};
@@ -0,0 +1,22 @@
+#pragma once
+/**
+ * Stack high-water mark of a single call.
+ *
+ * stackPaint() fills the free stack below the caller with a pattern,
+ * stackMeasure() called afterwards from the same function counts the bytes 
+ * that no longer hold the pattern. Both must be called at the same stack 
+ * depth, e.g. immediately before and after the call to be measured.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+constexpr size_t STACK_PROBE_DEPTH = 256;
+#elif defined(ESP8266)
+constexpr size_t STACK_PROBE_DEPTH = 1024;
+#else
+constexpr size_t STACK_PROBE_DEPTH = 2048;
+#endif
+
+void     stackPaint();
+uint16_t stackMeasure();
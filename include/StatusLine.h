@@ -0,0 +1,43 @@
+#pragma once
+/**
+ * A status line kept on the top line of an ANSI terminal.
+ *
+ * The line is divided into fields of fixed width. A field is redrawn only
+ * from its first changed character on, framed by save and restore cursor,
+ * so the cursor returns to the line being typed and an update of a clock 
+ * costs a dozen bytes. The top line is taken out of the scrolling region.
+ */
+#include <Print.h>
+#include <stdint.h>
+
+constexpr uint8_t STATUS_FIELDS = 4;
+constexpr uint8_t STATUS_WIDTH  = 18;  // columns per field
+constexpr uint8_t TERM_ROWS     = 24;  // rows of the terminal
+
+class StatusLine
+{
+  public:
+    void begin(Print& out, uint16_t period);
+    void end(Print& out);
+    bool active() const { return period != 0; }
+    bool due(uint32_t now);
+    void field(Print& out, uint8_t i, const char* text);
+
+  private:
+    uint16_t period = 0;                            // ms between updates, 0 = off
+    uint32_t last = 0;
+    char     shown[STATUS_FIELDS][STATUS_WIDTH + 1];
+};
+
+/**
+ * Takes the place of the status line in a profile without it
+ */
+class NoStatusLine
+{
+  public:
+    void begin(Print&, uint16_t) {}
+    void end(Print&) {}
+    bool active() const { return false; }
+    bool due(uint32_t) { return false; }
+    void field(Print&, uint8_t, const char*) {}
+};
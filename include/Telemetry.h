@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * Binary telemetry stream.
+ *
+ * At a fixed rate a frame with a timestamp and the readings of the analog
+ * channels is sampled into one of two frame buffers, while the other one 
+ * is sent. Frames are sent only as far as the transport takes them without
+ * blocking. A frame due while both buffers are still busy is dropped and 
+ * counted. tools/telemetry_decode.py decodes the stream on the host.
+ *
+ * Frame layout, little endian:
+ *   A5 5A  seq:u16  micros:u32  channel:i16 * TELEMETRY_CHANNELS  crc16:u16
+ * The CRC-16/XMODEM covers everything from seq to the last channel.
+ */
+#include <Arduino.h>
+
+constexpr uint8_t TELEMETRY_CHANNELS = 4;
+
+struct __attribute__((packed)) TelemetryFrame
+{
+  uint8_t  sync[2];
+  uint16_t seq;
+  uint32_t micros;
+  int16_t  channel[TELEMETRY_CHANNELS];
+  uint16_t crc;
+};
+
+class Telemetry
+{
+  public:
+    void start(Print* out, uint16_t rate);
+    void stop();
+    bool active() const { return out != nullptr; }
+    void poll();
+
+    uint32_t sent = 0;          // frames completely sent
+    uint32_t dropped = 0;       // frames that found no free buffer
+
+  private:
+    void sample(TelemetryFrame& frame);
+
+    Print*         out = nullptr;
+    uint32_t       period = 0;  // us between frames
+    uint32_t       due = 0;     // micros() of the next frame
+    uint16_t       seq = 0;
+    TelemetryFrame frames[2] = {};
+    uint8_t        head = 0;    // frame being sent
+    uint8_t        count = 0;   // frames waiting, 0 to 2
+    uint8_t        offset = 0;  // bytes of frames[head] already sent
+};
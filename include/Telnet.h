@@ -0,0 +1,44 @@
+#pragma once
+/**
+ * Telnet transport for the menu on ESP32 and ESP8266.
+ *
+ * TelnetStream is a Stream like Serial, so the menu can read from and write 
+ * to either one. It wraps one client taken over from a WiFiServer, strips 
+ * the telnet option negotiation from the input and asks the client for 
+ * character mode, so every keystroke is sent immediately.
+ */
+#if defined(ESP32) || defined(ESP8266)
+#define HAS_TELNET 1
+
+#include <Arduino.h>
+#if defined(ESP32)
+#include <WiFi.h>
+#else
+#include <ESP8266WiFi.h>
+#endif
+#include "TelnetFilter.h"
+
+class TelnetStream : public Stream
+{
+  public:
+    void accept(WiFiServer& server);
+    bool connected();
+
+    int    available() override;
+    int    read() override;
+    int    peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int    availableForWrite() override;
+    void   flush() override;
+
+  private:
+    bool fill();
+
+    WiFiClient   client;
+    TelnetFilter filter;
+    int          next = -1; // data byte read ahead, -1 if none
+};
+#else
+#define HAS_TELNET 0
+#endif
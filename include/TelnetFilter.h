@@ -0,0 +1,25 @@
+#pragma once
+/**
+ * Strips the telnet option negotiation from the bytes a client sends.
+ *
+ * The bytes are taken one at a time, in whatever pieces they arrive, so a
+ * command split between two TCP segments is still recognized: the state 
+ * of the negotiation is kept from one byte to the next.
+ */
+#include <stdint.h>
+
+class TelnetFilter
+{
+  public:
+    // Telnet commands and options used by the transport
+    enum : uint8_t { SE = 240, SB = 250, WILL = 251, WONT = 252, DO = 253, DONT = 254, IAC = 255 };
+    enum : uint8_t { OPT_ECHO = 1, OPT_SGA = 3 };
+
+    int  take(uint8_t c);
+    void reset() { state = Data; }
+
+  private:
+    enum State : uint8_t { Data, Command, Option, Sub, SubIac };
+
+    State state = Data;
+};
@@ -0,0 +1,67 @@
+#pragma once
+/**
+ * YMODEM file transfer between the host and LittleFS on ESP32 and ESP8266.
+ *
+ * The transfer runs as a state machine driven by poll() from the main loop,
+ * so the loop keeps running. Blocks of 128 or 1024 bytes pass through one 
+ * block buffer, are checked with CRC-16 and written to or read from the 
+ * file as they come, the file itself is never held in memory. Received 
+ * files are stored under their name in the root directory.
+ */
+#if defined(ESP32) || defined(ESP8266)
+#define HAS_YMODEM 1
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+constexpr uint16_t YMODEM_BLOCK   = 1024;
+constexpr uint8_t  YMODEM_NAME    = 32;    // longest path, LittleFS allows 31 characters
+constexpr uint8_t  YMODEM_RETRIES = 10;    // bad blocks in a row before giving up
+
+class Ymodem
+{
+  public:
+    bool receive(Stream* io);
+    bool send(Stream* io, const char* path);
+    void poll();
+    bool active() const { return io != nullptr; }
+
+    bool     ok;                // the last transfer completed
+    uint8_t  files;             // files transferred
+    uint32_t bytes;             // file bytes transferred
+    uint32_t elapsed;           // ms from the start to the end of the transfer
+
+  private:
+    enum State : uint8_t { Start, Block, Sending, WaitAck };
+    enum Phase : uint8_t { Header, Data, Eot, Final };
+
+    void begin(Stream* io, State state);
+    void finish(bool ok);
+    void abort();
+    void control(uint8_t c);
+    void rxByte(uint8_t c);
+    void rxBlock();
+    bool rxHeader();
+    void txByte(uint8_t c);
+    void txBlock(uint16_t size);
+    void txNext();
+    void txPump();
+
+    Stream*  io = nullptr;
+    File     file;
+    State    state;
+    Phase    phase;
+    bool     sending;           // direction of the transfer
+    uint8_t  retries;
+    uint8_t  seq;               // block number expected or sent last
+    uint8_t  cans;              // CAN received in a row
+    uint16_t length;            // bytes of the block on the wire
+    uint16_t pos;               // bytes of the block received or sent
+    uint32_t remaining;         // file bytes still to be stored or sent
+    uint32_t started;
+    uint32_t timer;             // millis() of the last progress
+    uint8_t  block[3 + YMODEM_BLOCK + 2];  // header, number, complement, data, CRC
+};
+#else
+#define HAS_YMODEM 0
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * Menu of single key commands.
+ *
+ * A Menu<Capacity> holds up to Capacity menuitems, each composed of a key,
+ * a text, an argument and an action, with all storage inside the object.
+ * It can be built at compile time, then the keys are packed apart already
+ * and the menu may live in a constexpr object. The menu has no output of 
+ * its own, texts are printed to the Print passed in. Everything is inline,
+ * so finding and running an item compiles to a memchr() and one indirect
+ * call at the place of use.
+ *
+ *   constexpr MenuItem items[] = { { 'h', "[h] Say Hello", "Guten Tag", sayHello } };
+ *   constexpr Menu<1> menu(items);
+ *   menu.dispatch(key);
+ */
+#include <Print.h>
+#include <stdint.h>
+#include <string.h>
+
+// The action gets the argument of its menuitem
+using Action = void(*)(const char*);
+
+struct MenuItem
+{
+  char        key;
+  const char* txt;
+  const char* arg;
+  Action      action;
+};
+
+// An action taking an argument of any type T instead of a text. call<> binds
+// the value V to the typed action Fn at compile time and yields a plain 
+// Action, so dispatching it costs the same indirect call as any menuitem:
+//   { 'p', "[p] Read pin 0", "", call<uint8_t, buttonPin, readPin> }
+template<typename T, const T& V, void (*Fn)(T)>
+void call(const char*) { Fn(V); }
+
+template<typename T, const T& V, void (*Fn)(const T&)>
+void call(const char*) { Fn(V); }
+
+
+template<uint8_t Capacity>
+class Menu
+{
+  public:
+    constexpr Menu() = default;
+
+    template<uint8_t N>
+    constexpr Menu(const MenuItem (&items)[N])
+    {
+      static_assert(N <= Capacity, "more menuitems than the capacity of the menu");
+      for (const MenuItem& item : items) add(item);
+    }
+
+    constexpr bool add(const MenuItem& item)
+    {
+      if (count == Capacity) return false;
+      items[count] = item;
+      keys[count]  = item.key;
+      count++;
+      return true;
+    }
+
+    constexpr uint8_t         size() const { return count; }
+    constexpr const MenuItem& operator[](uint8_t i) const { return items[i]; }
+
+    // Index of the menuitem of key, -1 if there is none. The keys are packed
+    // apart from texts, args and actions, so the lookup scans count bytes.
+    int find(char key) const
+    {
+      const char* found = (const char*)memchr(keys, key, count);
+      return found ? found - keys : -1;
+    }
+
+    void run(uint8_t i) const { items[i].action(items[i].arg); }
+
+    bool dispatch(char key) const
+    {
+      int i = find(key);
+      if (i < 0) return false;
+      run(i);
+      return true;
+    }
+
+    void print(Print& out, uint8_t i) const { out.print(items[i].txt); }
+
+  private:
+    MenuItem items[Capacity] = {};
+    char     keys[Capacity] = {};
+    uint8_t  count = 0;
+};
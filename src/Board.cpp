@@ -0,0 +1,147 @@
+#include "Board.h"
+#include "CliParse.h"
+#if defined(BOARD_HOST)
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+bool hostPins[HOST_PINS];
+
+/**
+ * The terminal of the host as UART, its input read without blocking
+ */
+class HostUart : public Stream
+{
+  public:
+    void begin() { fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK); }
+
+    int    available() override { return peek() >= 0; }
+    int    read() override
+    {
+      int c = peek();
+      next = -1;
+      return c;
+    }
+    int    peek() override
+    {
+      uint8_t c;
+
+      if (next < 0 && ::read(STDIN_FILENO, &c, 1) == 1) next = c;
+      return next;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override
+    {
+      ssize_t n = ::write(STDOUT_FILENO, buf, size);
+      return n > 0 ? n : 0;
+    }
+    int    availableForWrite() override { return PIPE_BUF; }
+    using  Print::write;
+
+  private:
+    int next = -1;  // byte read ahead, -1 if none
+};
+
+static HostUart uart;
+#endif
+
+
+void OutputPin::begin(uint8_t pin)
+{
+#if ! defined(BOARD_HOST)
+  pinMode(pin, OUTPUT);
+#endif
+#if defined(__AVR__)
+  port = portOutputRegister(digitalPinToPort(pin));
+  mask = digitalPinToBitMask(pin);
+#else
+  this->pin = pin;
+  mask = 1UL << (pin % 32);
+#endif
+}
+
+
+Stream& uartBegin(uint32_t baud)
+{
+#if defined(BOARD_HOST)
+  uart.begin();
+  return uart;
+#else
+  Serial.begin(baud);
+  return Serial;
+#endif
+}
+
+
+/**
+ * Switch to another baud rate, the caller waits for the data sent so far
+ */
+void uartBaud(uint32_t baud)
+{
+#if defined(ESP32) || defined(ESP8266)
+  Serial.updateBaudRate(baud);
+#elif ! defined(BOARD_HOST)
+  Serial.end();
+  Serial.begin(baud);
+#endif
+}
+
+
+/**
+ * RTS/CTS flow control, only the UART of the ESP32 can remap its pins for it
+ */
+bool uartHardwareFlow(int8_t cts, int8_t rts)
+{
+#if defined(ESP32)
+  // UART0 keeps its default RX 3 and TX 1
+  return Serial.setPins(3, 1, cts, rts) && Serial.setHwFlowCtrlMode(UART_HW_FLOWCTRL_CTS_RTS, 100);
+#else
+  return false;
+#endif
+}
+
+
+#if defined(__AVR__) || defined(BOARD_HOST)
+// The seconds of the clock advance with millis(). Moving the base along 
+// on every read keeps the clock right across the wrap of millis(). The 
+// host keeps its own clock like this, setting it needs no privileges.
+static time_t   rtcBase;
+static uint32_t rtcBaseMs;
+static bool     rtcValid;
+
+bool rtcGet(tm& time)
+{
+  if (! rtcValid) return false;
+  uint32_t seconds = (millis() - rtcBaseMs) / 1000;
+  rtcBase   += seconds;
+  rtcBaseMs += seconds * 1000;
+  localtime_r(&rtcBase, &time);
+  return true;
+}
+
+
+void rtcSet(tm& time)
+{
+  rtcBase   = mktime(&time);
+  rtcBaseMs = millis();
+  rtcValid  = true;
+}
+#else
+bool rtcGet(tm& time)
+{
+  time_t now = ::time(nullptr);
+  tm     local;
+
+  localtime_r(&now, &local);
+  if (local.tm_year + 1900 < DATE_MIN_YEAR) return false;  // never set
+  time = local;
+  return true;
+}
+
+
+void rtcSet(tm& time)
+{
+  timeval tv = { mktime(&time), 0 };
+  settimeofday(&tv, nullptr);
+}
+#endif
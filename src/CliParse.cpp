@@ -0,0 +1,101 @@
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CliParse.h"
+
+/**
+ * Skip trailing blanks and line ends, true if nothing else follows
+ */
+static bool atEnd(const char* p)
+{
+  while (isspace((unsigned char)*p)) p++;
+  return *p == '\0';
+}
+
+
+bool parseInteger(const char* str, int32_t& value)
+{
+  char* end;
+  long  v;
+
+  if (str == nullptr) return false;
+  errno = 0;
+  v = strtol(str, &end, 10);
+  if (end == str || errno == ERANGE || ! atEnd(end)) return false;
+  if (v < INT32_MIN || v > INT32_MAX) return false;
+  value = (int32_t)v;
+  return true;
+}
+
+
+bool parseFloat(const char* str, double& value)
+{
+  char*  end;
+  double v;
+
+  if (str == nullptr) return false;
+  errno = 0;
+  v = strtod(str, &end);
+  if (end == str || errno == ERANGE || ! atEnd(end) || ! isfinite(v)) return false;
+  value = v;
+  return true;
+}
+
+
+static bool isLeapYear(int y)
+{
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+
+/**
+ * Accepts yyyy mm dd hh mm ss with any single character as separator
+ */
+bool parseDateTime(const char* str, tm& time)
+{
+  static const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  int y, mo, d, h, mi, s, n = 0;
+  tm  t;
+
+  if (str == nullptr) return false;
+  if (sscanf(str, "%4d%*c%2d%*c%2d%*c%2d%*c%2d%*c%2d%n", &y, &mo, &d, &h, &mi, &s, &n) != 6) return false;
+  if (! atEnd(str + n)) return false;
+  if (y < DATE_MIN_YEAR || y > DATE_MAX_YEAR || mo < 1 || mo > 12 || d < 1 || d > daysInMonth[mo - 1] + (mo == 2 && isLeapYear(y)) ||
+      h < 0 || h > 23 || mi < 0 || mi > 59 || s < 0 || s > 59) return false;
+
+  memset(&t, 0, sizeof(t));
+  t.tm_year  = y - 1900;
+  t.tm_mon   = mo - 1;
+  t.tm_mday  = d;
+  t.tm_hour  = h;
+  t.tm_min   = mi;
+  t.tm_sec   = s;
+  t.tm_isdst = -1;
+  time = t;
+  return true;
+}
+
+
+/**
+ * Accepts start and length, each decimal or hexadecimal with 0x, separated by blanks
+ */
+bool parseRange(const char* str, uint32_t& start, uint32_t& length)
+{
+  char*         end;
+  unsigned long s, n;
+
+  if (str == nullptr || strchr(str, '-')) return false;  // strtoul() would negate
+  errno = 0;
+  s = strtoul(str, &end, 0);
+  if (end == str || ! isspace((unsigned char)*end)) return false;
+  str = end;
+  n = strtoul(str, &end, 0);
+  if (end == str || errno == ERANGE || ! atEnd(end)) return false;
+  if (s > UINT32_MAX || n == 0 || n - 1 > UINT32_MAX - s) return false;
+  start  = s;
+  length = n;
+  return true;
+}
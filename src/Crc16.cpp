@@ -0,0 +1,14 @@
+#include "Crc16.h"
+
+uint16_t crc16(const uint8_t* data, size_t size, uint16_t crc)
+{
+  while (size--)
+  {
+    crc ^= (uint16_t)*data++ << 8;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
@@ -0,0 +1,86 @@
+#include <Arduino.h>
+#include "Cycles.h"
+
+#if defined(__AVR__)
+static volatile uint16_t overflows;
+static uint8_t           savedA, savedB, savedMask;  // Timer1 as set up by the core
+
+ISR(TIMER1_OVF_vect)
+{
+  overflows++;
+}
+
+
+void cyclesBegin()
+{
+  savedA    = TCCR1A;
+  savedB    = TCCR1B;
+  savedMask = TIMSK1;
+  TCCR1A    = 0;
+  TCCR1B    = _BV(CS10);   // normal mode, no prescaler
+  TCNT1     = 0;
+  overflows = 0;
+  TIFR1     = _BV(TOV1);
+  TIMSK1    = _BV(TOIE1);
+}
+
+
+void cyclesEnd()
+{
+  TIMSK1 = savedMask;
+  TCCR1A = savedA;
+  TCCR1B = savedB;
+}
+
+
+uint32_t cycles()
+{
+  uint8_t sreg = SREG;
+
+  cli();
+  uint16_t low  = TCNT1;
+  uint16_t high = overflows;
+  if ((TIFR1 & _BV(TOV1)) && low < 0x8000) high++;  // overflow not yet counted by the ISR
+  SREG = sreg;
+  return (uint32_t)high << 16 | low;
+}
+
+
+uint16_t cyclesPerMicro()
+{
+  return F_CPU / 1000000UL;
+}
+#elif defined(ARDUINO)
+void cyclesBegin() {}
+void cyclesEnd() {}
+
+
+uint32_t cycles()
+{
+  return ESP.getCycleCount();  // reads CCOUNT
+}
+
+
+uint16_t cyclesPerMicro()
+{
+  return ESP.getCpuFreqMHz();
+}
+#else
+// The native env counts nanoseconds of the steady clock as cycles
+#include <chrono>
+
+void cyclesBegin() {}
+void cyclesEnd() {}
+
+
+uint32_t cycles()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+uint16_t cyclesPerMicro()
+{
+  return 1000;
+}
+#endif
@@ -0,0 +1,113 @@
+#include <Arduino.h>
+#if ! defined(__AVR__)
+#include <atomic>
+#endif
+#include "EdgeTrigger.h"
+
+#ifndef IRAM_ATTR
+  #define IRAM_ATTR
+#endif
+
+// An index of the queue is stored with release and loaded with acquire 
+// semantics, so an event is complete before its index is seen and a slot
+// is read before it is handed back to the interrupts.
+#if defined(__AVR__)
+// The AVR has no <atomic>. Its single core needs only a compiler barrier,
+// which keeps the accesses of the queue on their side of the index.
+using Index = volatile uint8_t;
+
+static inline uint8_t load(Index& index)
+{
+  uint8_t i = index;
+  __asm__ __volatile__("" ::: "memory");
+  return i;
+}
+
+static inline void store(Index& index, uint8_t i)
+{
+  __asm__ __volatile__("" ::: "memory");
+  index = i;
+}
+#else
+using Index = std::atomic<uint8_t>;
+
+static inline uint8_t IRAM_ATTR load(Index& index) { return index.load(std::memory_order_acquire); }
+static inline void    IRAM_ATTR store(Index& index, uint8_t i) { index.store(i, std::memory_order_release); }
+#endif
+
+// Single producer (the interrupts, which don't nest), single consumer (the loop)
+static EdgeEvent         queue[EDGE_QUEUE];
+static Index             head;   // next event to be taken, written by the loop only
+static Index             tail;   // next free slot, written by the interrupts only
+static volatile uint32_t overflows;
+static EdgeStats         stats = { 0, UINT32_MAX, 0, 0, 0 };
+
+
+static void IRAM_ATTR push(uint8_t binding)
+{
+  uint8_t t = load(tail);
+
+  if ((uint8_t)(t - load(head)) == EDGE_QUEUE)
+  {
+    overflows++;
+    return;
+  }
+  queue[t % EDGE_QUEUE].binding = binding;
+  queue[t % EDGE_QUEUE].micros  = micros();
+  store(tail, t + 1);  // publish the event only after it is complete
+}
+
+
+// attachInterrupt() takes no argument on every core, so each binding gets its own handler
+template<uint8_t N>
+static void IRAM_ATTR onEdge()
+{
+  push(N);
+}
+
+static void (*const handlers[EDGE_BINDINGS])() = { onEdge<0>, onEdge<1>, onEdge<2>, onEdge<3> };
+
+
+void edgeAttach(uint8_t binding, uint8_t pin, int mode)
+{
+  if (binding >= EDGE_BINDINGS) return;
+  pinMode(pin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(pin), handlers[binding], mode);
+}
+
+
+void edgeInject(uint8_t binding)
+{
+  noInterrupts();
+  push(binding);
+  interrupts();
+}
+
+
+bool edgePop(EdgeEvent& event)
+{
+  uint8_t h = load(head);
+
+  if (h == load(tail)) return false;
+  event = queue[h % EDGE_QUEUE];
+  store(head, h + 1);  // the slot may be reused from now on
+  return true;
+}
+
+
+void edgeLatency(uint32_t us)
+{
+  stats.count++;
+  stats.total += us;
+  if (us < stats.min) stats.min = us;
+  if (us > stats.max) stats.max = us;
+}
+
+
+const EdgeStats& edgeStats()
+{
+  noInterrupts();     // the AVR reads the counter a byte at a time
+  stats.overflows = overflows;
+  interrupts();
+  return stats;
+}
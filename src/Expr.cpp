@@ -0,0 +1,226 @@
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include "Expr.h"
+
+namespace
+{
+  enum Op : uint8_t { Paren, Shl, Shr, Add, Sub, Mul, Div, Mod, Neg, Plus };
+
+  uint8_t precedence(Op op)
+  {
+    switch (op)
+    {
+      case Shl: case Shr:          return 1;
+      case Add: case Sub:          return 2;
+      case Mul: case Div: case Mod: return 3;
+      case Neg: case Plus:         return 4;
+      default:                     return 0;
+    }
+  }
+
+  bool unary(Op op) { return op == Neg || op == Plus; }
+
+
+  // Integer arithmetic wraps around like the hardware does, but never divides by 0
+  bool arith(Op op, int32_t a, int32_t b, int32_t& r)
+  {
+    switch (op)
+    {
+      case Add:  r = (int32_t)((uint32_t)a + (uint32_t)b); return true;
+      case Sub:  r = (int32_t)((uint32_t)a - (uint32_t)b); return true;
+      case Mul:  r = (int32_t)((uint32_t)a * (uint32_t)b); return true;
+      case Div:  if (b == 0 || (a == INT32_MIN && b == -1)) return false; r = a / b; return true;
+      case Mod:  if (b == 0 || (a == INT32_MIN && b == -1)) return false; r = a % b; return true;
+      case Shl:  if (b < 0 || b > 31) return false; r = (int32_t)((uint32_t)a << b); return true;
+      case Shr:  if (b < 0 || b > 31) return false; r = a >> b; return true;
+      case Neg:  r = (int32_t)(0u - (uint32_t)b); return true;
+      case Plus: r = b; return true;
+      default:   return false;
+    }
+  }
+
+  bool arith(Op op, double a, double b, double& r)
+  {
+    switch (op)
+    {
+      case Add:  r = a + b; break;
+      case Sub:  r = a - b; break;
+      case Mul:  r = a * b; break;
+      case Div:  if (b == 0) return false; r = a / b; break;
+      case Neg:  r = -b; break;
+      case Plus: r = b; break;
+      default:   return false;
+    }
+    return isfinite(r);
+  }
+
+
+  // A decimal number may be 2^31 if it is negated, as in -2147483648
+  bool number(const char*& p, int32_t& v, bool negated)
+  {
+    char* end;
+    bool  hex = p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+
+    errno = 0;
+    unsigned long u = strtoul(p, &end, hex ? 16 : 10);
+    if (end == p || errno == ERANGE || u > UINT32_MAX) return false;
+    if (! hex && u > (negated ? 0x80000000UL : (unsigned long)INT32_MAX)) return false;
+    if (*end == '.' || *end == 'e' || *end == 'E') return false;  // no floats here
+    v = (int32_t)(uint32_t)u;  // hex literals may set the sign bit
+    p = end;
+    return true;
+  }
+
+  bool number(const char*& p, double& v, bool negated)
+  {
+    char* end;
+
+    errno = 0;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) v = strtoul(p, &end, 16);
+    else v = strtod(p, &end);
+    if (end == p || errno == ERANGE) return false;
+    p = end;
+    return true;
+  }
+
+
+  // A variable may hold any integer, but no NaN or infinity
+  bool valid(int32_t)  { return true; }
+  bool valid(double d) { return isfinite(d); }
+
+
+  template<typename T>
+  class Evaluator
+  {
+    public:
+      bool run(const char* p, T& result, Lookup<T> lookup);
+
+    private:
+      bool reduce();
+      bool push(T v);
+      bool push(Op op);
+
+      T       values[EXPR_DEPTH];
+      Op      ops[EXPR_DEPTH];
+      uint8_t nValues = 0;
+      uint8_t nOps = 0;
+  };
+
+  template<typename T>
+  bool Evaluator<T>::push(T v)
+  {
+    if (nValues == EXPR_DEPTH) return false;
+    values[nValues++] = v;
+    return true;
+  }
+
+  template<typename T>
+  bool Evaluator<T>::push(Op op)
+  {
+    if (nOps == EXPR_DEPTH) return false;
+    ops[nOps++] = op;
+    return true;
+  }
+
+  /**
+   * Apply the operator on top of the stack to its operands
+   */
+  template<typename T>
+  bool Evaluator<T>::reduce()
+  {
+    Op op = ops[--nOps];
+    T  r;
+
+    if (nValues < (unary(op) ? 1 : 2)) return false;
+    T b = values[--nValues];
+    T a = unary(op) ? 0 : values[--nValues];
+    if (! arith(op, a, b, r)) return false;
+    values[nValues++] = r;
+    return true;
+  }
+
+  template<typename T>
+  bool Evaluator<T>::run(const char* p, T& result, Lookup<T> lookup)
+  {
+    bool operand = true;   // an operand or a unary operator is expected
+
+    for (;;)
+    {
+      while (isspace((unsigned char)*p)) p++;
+      char c = *p;
+
+      if (operand)
+      {
+        T v;
+        if (c == '(')                   { p++; if (! push(Paren)) return false; continue; }
+        if (c == '-')                   { p++; if (! push(Neg)) return false; continue; }
+        if (c == '+')                   { p++; if (! push(Plus)) return false; continue; }
+        if (isdigit((unsigned char)c) || c == '.')
+        {
+          if (! number(p, v, nOps > 0 && ops[nOps - 1] == Neg)) return false;
+        }
+        else if (isalpha((unsigned char)c) || c == '_')
+        {
+          const char* name = p;
+          while (isalnum((unsigned char)*p) || *p == '_') p++;
+          if (lookup == nullptr || ! lookup(name, p - name, v) || ! valid(v)) return false;
+        }
+        else return false;
+        if (! push(v)) return false;
+        operand = false;
+        continue;
+      }
+
+      // an operand was read, a binary operator, a closing parenthesis or the end follows
+      Op op;
+      switch (c)
+      {
+        case '\0':
+        case ')':
+          while (nOps > 0 && ops[nOps - 1] != Paren) if (! reduce()) return false;
+          if (c == '\0')
+          {
+            if (nOps > 0 || nValues != 1) return false;
+            result = values[0];
+            return true;
+          }
+          if (nOps == 0) return false;
+          nOps--;  // drop the parenthesis
+          p++;
+          continue;
+        case '+': op = Add; break;
+        case '-': op = Sub; break;
+        case '*': op = Mul; break;
+        case '/': op = Div; break;
+        case '%': op = Mod; break;
+        case '<': if (p[1] != '<') return false; op = Shl; p++; break;
+        case '>': if (p[1] != '>') return false; op = Shr; p++; break;
+        default:  return false;
+      }
+      p++;
+      // operators of the same precedence are applied left to right
+      while (nOps > 0 && ops[nOps - 1] != Paren && precedence(ops[nOps - 1]) >= precedence(op))
+      {
+        if (! reduce()) return false;
+      }
+      if (! push(op)) return false;
+      operand = true;
+    }
+  }
+}
+
+
+bool evaluate(const char* expr, int32_t& result, IntLookup lookup)
+{
+  Evaluator<int32_t> e;
+  return expr && e.run(expr, result, lookup);
+}
+
+
+bool evaluate(const char* expr, double& result, VarLookup lookup)
+{
+  Evaluator<double> e;
+  return expr && e.run(expr, result, lookup);
+}
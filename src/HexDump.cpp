@@ -0,0 +1,152 @@
+#include "Format.h"
+#include "HexDump.h"
+
+// Memory that can be read as RAM, first and end address. The bounds are 
+// multiples of DUMP_ROW, so the rows of a range stay inside as well.
+struct Region { uint32_t low, high; };
+
+#if defined(ESP32)
+static const Region regions[] = 
+{
+  { 0x3FF80000, 0x3FF82000 },   // RTC fast memory
+  { 0x3FF90000, 0x3FFA0000 },   // internal ROM 1
+  { 0x3FFAE000, 0x40000000 },   // DRAM
+  { 0x40000000, 0x40060000 },   // internal ROM 0
+  { 0x40080000, 0x400A0000 },   // IRAM
+  { 0x50000000, 0x50002000 },   // RTC slow memory
+};
+#elif defined(ESP8266)
+static const Region regions[] = 
+{
+  { 0x3FFE8000, 0x40000000 },   // DRAM
+  { 0x40000000, 0x40010000 },   // boot ROM
+  { 0x40100000, 0x40108000 },   // IRAM
+};
+#else
+static const Region regions[] = 
+{
+  { RAMSTART, RAMEND + 1 },     // SRAM, without the registers below
+};
+#endif
+
+
+/**
+ * Dump length bytes from address from of source to out. Returns false if
+ * the range is not readable.
+ */
+bool HexDump::start(Print* out, Source source, uint32_t from, uint32_t length)
+{
+  if (! readable(source, from, from + (length - 1))) return false;
+
+  this->out    = out;
+  this->source = source;
+  first = from;
+  last  = from + (length - 1);
+  row   = from & ~(uint32_t)(DUMP_ROW - 1);
+  return true;
+}
+
+
+/**
+ * True if the addresses first to last all lie in the flash chip or in one
+ * region of RAM or ROM
+ */
+bool HexDump::readable(Source source, uint32_t first, uint32_t last)
+{
+  if (source == Flash)
+  {
+#if defined(__AVR__)
+    return last <= FLASHEND;
+#else
+    return last < ESP.getFlashChipSize();
+#endif
+  }
+  for (const Region& r : regions)
+  {
+    if (first >= r.low && last < r.high) return true;
+  }
+  return false;
+}
+
+
+/**
+ * Read the row at address row. Words are read aligned, as parts of 
+ * the ESP32 memory only allow 32 bit access. Returns false if the
+ * flash could not be read.
+ */
+bool HexDump::fetch(uint8_t* data, uint32_t row)
+{
+#if defined(__AVR__)
+  for (uint8_t i = 0; i < DUMP_ROW; i++)
+  {
+    uint16_t addr = row + i;
+    data[i] = source == Flash ? pgm_read_byte(addr) : *(volatile uint8_t*)addr;
+  }
+#else
+  uint32_t words[DUMP_ROW / 4];
+
+  if (source == Flash)
+  {
+    if (! ESP.flashRead(row, words, DUMP_ROW)) return false;
+  }
+  else
+  {
+    for (uint8_t i = 0; i < DUMP_ROW / 4; i++) words[i] = *(volatile uint32_t*)(uintptr_t)(row + 4 * i);
+  }
+  memcpy(data, words, DUMP_ROW);
+#endif
+  return true;
+}
+
+
+void HexDump::format(Print& line, const uint8_t* data, uint32_t row)
+{
+  emit(line, hex(row, DUMP_DIGITS), ' ');
+  for (uint8_t i = 0; i < DUMP_ROW; i++)
+  {
+    uint32_t addr = row + i;
+    if (i == DUMP_ROW / 2) line.write(' ');
+    if (addr < first || addr > last) line.print("   ");
+    else emit(line, ' ', hex(data[i], 2));
+  }
+  line.print("  |");
+  for (uint8_t i = 0; i < DUMP_ROW; i++)
+  {
+    uint32_t addr = row + i;
+    char     c = data[i] >= ' ' && data[i] < 0x7F ? data[i] : '.';
+    line.write(addr < first || addr > last ? ' ' : c);
+  }
+  line.print("|\r\n");
+}
+
+
+/**
+ * Send the next rows, as far as the output takes them
+ */
+void HexDump::poll()
+{
+  if (! active()) return;
+
+  char        buf[DUMP_LINE + 1];
+  BufferPrint line(buf, sizeof(buf));
+  uint8_t     data[DUMP_ROW];
+
+  for (uint8_t n = 0; n < DUMP_CHUNK && out->availableForWrite() >= DUMP_LINE; n++)
+  {
+    if (! fetch(data, row))
+    {
+      emit(*out, "Read error at ", hex(row, DUMP_DIGITS), "\r\n");
+      stop();
+      return;
+    }
+    line.clear();
+    format(line, data, row);
+    out->write((const uint8_t*)line.c_str(), line.length());
+    if (last - row < DUMP_ROW)  // the range ends in this row
+    {
+      stop();
+      return;
+    }
+    row += DUMP_ROW;
+  }
+}
@@ -0,0 +1,150 @@
+#include <ctype.h>
+#include <string.h>
+#include "Format.h"
+#include "JsonLine.h"
+
+
+JsonToken JsonTokenizer::next()
+{
+  char c;
+
+  while ((c = held ? held : *p) == ' ' || c == '\t' || c == '\r' || c == '\n')
+  {
+    held = 0;
+    p++;
+  }
+  if (c == '\0') return JsonToken::End;
+
+  held = 0;
+  switch (c)
+  {
+    case '{': p++; return JsonToken::BeginObject;
+    case '}': p++; return JsonToken::EndObject;
+    case ':': p++; return JsonToken::Colon;
+    case ',': p++; return JsonToken::Comma;
+    case '"': p++; return string();
+    default:
+      if (c == '-' || isdigit((unsigned char)c)) return scalar(JsonToken::Number);
+      if (isalpha((unsigned char)c))              return scalar(JsonToken::Literal);
+      return JsonToken::Error;
+  }
+}
+
+
+/**
+ * Unescape the string in place, the closing quote becomes its terminator
+ */
+JsonToken JsonTokenizer::string()
+{
+  char* w = val = p;
+
+  for (;;)
+  {
+    char c = *p++;
+
+    if (c == '\0') return JsonToken::Error;
+    if (c == '"') break;
+    if (c == '\\')
+    {
+      switch (c = *p++)
+      {
+        case '"': case '\\': case '/': break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u':
+          {
+            // only ASCII code points are kept, others are replaced by '?'
+            unsigned cp = 0;
+            for (uint8_t i = 0; i < 4; i++, p++)
+            {
+              if (! isxdigit((unsigned char)*p)) return JsonToken::Error;
+              cp = cp * 16 + (isdigit((unsigned char)*p) ? *p - '0' : (*p | 0x20) - 'a' + 10);
+            }
+            c = cp < 0x80 ? cp : '?';
+          }
+          break;
+        default:
+          return JsonToken::Error;
+      }
+    }
+    *w++ = c;
+  }
+  *w = '\0';
+  return JsonToken::String;
+}
+
+
+/**
+ * Number or literal (true, false, null). The character following it is 
+ * overwritten by the terminator and kept in held.
+ */
+JsonToken JsonTokenizer::scalar(JsonToken type)
+{
+  val = p;
+  while (isalnum((unsigned char)*p) || *p == '-' || *p == '+' || *p == '.') p++;
+  held = *p;
+  *p = '\0';
+
+  if (type == JsonToken::Literal && strcmp(val, "true") && strcmp(val, "false") && strcmp(val, "null"))
+    return JsonToken::Error;
+  return type;
+}
+
+
+/**
+ * Extract the command key and the optional argument of a request. Both 
+ * point into line afterwards.
+ */
+bool parseJsonRequest(char* line, char& cmd, const char*& arg)
+{
+  JsonTokenizer json(line);
+  JsonToken     token;
+
+  cmd = '\0';
+  arg = nullptr;
+  if (json.next() != JsonToken::BeginObject) return false;
+
+  token = json.next();
+  while (token != JsonToken::EndObject)
+  {
+    if (token != JsonToken::String) return false;
+    const char* name = json.value();
+    if (json.next() != JsonToken::Colon) return false;
+
+    token = json.next();
+    if (token != JsonToken::String && token != JsonToken::Number && token != JsonToken::Literal) return false;
+    if (strcmp(name, "cmd") == 0)
+    {
+      if (token != JsonToken::String || strlen(json.value()) != 1) return false;
+      cmd = json.value()[0];
+    }
+    else if (strcmp(name, "arg") == 0)
+    {
+      arg = json.value();
+    }
+
+    token = json.next();
+    if (token == JsonToken::Comma)
+    {
+      token = json.next();
+      if (token == JsonToken::EndObject) return false;
+    }
+    else if (token != JsonToken::EndObject) return false;
+  }
+  return cmd != '\0' && json.next() == JsonToken::End;
+}
+
+
+void printJsonValue(Print& out, const JsonResult& result)
+{
+  switch (result.type)
+  {
+    case JsonResult::Integer: emit(out, ",\"value\":", result.i); break;
+    case JsonResult::Float:   emit(out, ",\"value\":", fixed(result.f, 6)); break;
+    case JsonResult::Bool:    emit(out, ",\"value\":", result.b ? "true" : "false"); break;
+    default: break;
+  }
+}
@@ -0,0 +1,88 @@
+#include <EEPROM.h>
+#include <string.h>
+#include "Macro.h"
+
+// EEPROM layout: magic byte, length, macro bytes
+constexpr uint8_t  MAGIC = 0xC1;
+constexpr uint16_t EEPROM_SIZE = 2 + MACRO_SIZE;
+
+
+void Macro::start()
+{
+  len      = 0;
+  overflow = false;
+  rec      = true;
+}
+
+
+/**
+ * End the recording and keep the macro. A macro that didn't fit is dropped.
+ */
+bool Macro::stop()
+{
+  rec = false;
+  if (overflow) len = 0;
+  save();
+  return ! overflow;
+}
+
+
+void Macro::key(char k)
+{
+  append((const uint8_t*)&k, 1);
+}
+
+
+void Macro::line(const char* text)
+{
+  append(&LINE_MARK, 1);
+  append((const uint8_t*)text, strlen(text) + 1);
+}
+
+
+void Macro::append(const uint8_t* bytes, uint8_t n)
+{
+  if (! rec || overflow) return;
+  if (len + n > MACRO_SIZE)
+  {
+    overflow = true;
+    return;
+  }
+  memcpy(buf + len, bytes, n);
+  len += n;
+}
+
+
+void Macro::save()
+{
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.begin(EEPROM_SIZE);
+#endif
+  EEPROM.write(0, MAGIC);
+  EEPROM.write(1, len);
+  for (uint8_t i = 0; i < len; i++) EEPROM.write(2 + i, buf[i]);
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.end();  // commits the changes to flash
+#endif
+}
+
+
+/**
+ * Read the macro saved in EEPROM, false if there is none
+ */
+bool Macro::load()
+{
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.begin(EEPROM_SIZE);
+#endif
+  len = 0;
+  if (EEPROM.read(0) == MAGIC && EEPROM.read(1) <= MACRO_SIZE)
+  {
+    len = EEPROM.read(1);
+    for (uint8_t i = 0; i < len; i++) buf[i] = EEPROM.read(2 + i);
+  }
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.end();
+#endif
+  return len > 0;
+}
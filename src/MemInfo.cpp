@@ -0,0 +1,78 @@
+#include <Arduino.h>
+#include "MemInfo.h"
+
+#if defined(__AVR__)
+// Symbols of the avr-libc allocator
+extern char* __brkval;
+extern char  __heap_start;
+struct __freelist { size_t sz; struct __freelist* nx; };
+extern struct __freelist* __flp;
+#endif
+
+static MemSample trace[MEM_TRACE_SIZE];
+static uint8_t   traceNext;
+static uint8_t   traceCount;
+#if ! defined(ESP32)
+static uint32_t  minFree = UINT32_MAX; // ESP32 keeps its own minimum
+#endif
+
+
+/**
+ * Fill s with the current figures read from the native heap APIs
+ */
+void memSample(MemSample& s, char key)
+{
+#if defined(ESP32)
+  s.freeHeap     = ESP.getFreeHeap();
+  s.largestBlock = ESP.getMaxAllocHeap();
+  s.minFreeHeap  = ESP.getMinFreeHeap();
+  s.stackFree    = uxTaskGetStackHighWaterMark(NULL);
+#elif defined(ESP8266)
+  s.freeHeap     = ESP.getFreeHeap();
+  s.largestBlock = ESP.getMaxFreeBlockSize();
+  s.stackFree    = ESP.getFreeContStack();
+#elif defined(__AVR__)
+  // The gap between heap top and stack pointer can be taken by either one
+  char  top;
+  char* brk = __brkval ? __brkval : &__heap_start;
+  uint32_t gap = &top - brk;
+
+  s.freeHeap     = gap;
+  s.largestBlock = gap;
+  for (__freelist* fp = __flp; fp; fp = fp->nx)
+  {
+    s.freeHeap += fp->sz;
+    if (fp->sz > s.largestBlock) s.largestBlock = fp->sz;
+  }
+  s.stackFree    = gap;
+#endif
+#if ! defined(ESP32)
+  if (s.freeHeap < minFree) minFree = s.freeHeap;
+  s.minFreeHeap  = minFree;
+#endif
+  s.ms  = millis();
+  s.key = key;
+  s.fragmentation = s.freeHeap ? 100 - (uint8_t)(s.largestBlock * 100 / s.freeHeap) : 0;
+}
+
+
+/**
+ * Append s to the trace buffer, overwriting the oldest sample
+ */
+void memTrace(const MemSample& s)
+{
+  trace[traceNext] = s;
+  traceNext = (traceNext + 1) % MEM_TRACE_SIZE;
+  if (traceCount < MEM_TRACE_SIZE) traceCount++;
+}
+
+
+/**
+ * Get the sample with the given age, 0 being the newest
+ */
+bool memTraceAt(uint8_t age, MemSample& s)
+{
+  if (age >= traceCount) return false;
+  s = trace[(traceNext + MEM_TRACE_SIZE - 1 - age) % MEM_TRACE_SIZE];
+  return true;
+}
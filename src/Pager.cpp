@@ -0,0 +1,133 @@
+#include <ctype.h>
+#include <string.h>
+#include "Format.h"
+#include "Pager.h"
+
+void Pager::open(LineCount count, PrintLine line)
+{
+  this->count = count;
+  this->line  = line;
+  current     = 0;
+  query[0]    = '\0';
+}
+
+
+/**
+ * Number of lines to be paged, the matches if a filter is active
+ */
+uint16_t Pager::size() const
+{
+  if (! active()) return 0;
+  return filtered() ? hits : count();
+}
+
+
+uint16_t Pager::pages() const
+{
+  uint16_t n = size();
+  return n ? (n + PAGE_LINES - 1) / PAGE_LINES : 1;
+}
+
+
+/**
+ * True if line i contains text, ignoring case
+ */
+bool Pager::contains(uint16_t i, const char* text) const
+{
+  char buf[80];
+  BufferPrint out(buf, sizeof(buf));
+
+  line(out, i);
+  for (const char* p = buf; *p; p++)
+  {
+    size_t k = 0;
+    while (text[k] && tolower((unsigned char)p[k]) == tolower((unsigned char)text[k])) k++;
+    if (text[k] == '\0') return true;
+  }
+  return false;
+}
+
+
+/**
+ * Restrict the pages to the lines containing text. If text contains the 
+ * current filter text, the result is a subset of the current matches and
+ * only these are tested. An empty text removes the filter.
+ */
+bool Pager::filter(const char* text)
+{
+  if (! active() || count() > FILTER_LINES || strlen(text) >= FILTER_SIZE) return false;
+  if (text[0] == '\0')
+  {
+    clearFilter();
+    return true;
+  }
+
+  uint16_t n      = count();
+  bool     refine = filtered() && strstr(text, query) != nullptr;
+
+  hits = 0;
+  for (uint16_t i = 0; i < n; i++)
+  {
+    bool hit = (! refine || matches(i)) && contains(i, text);
+    if (hit) 
+    {
+      bits[i / 8] |= (1 << (i % 8));
+      hits++;
+    }
+    else
+    {
+      bits[i / 8] &= ~(1 << (i % 8));
+    }
+  }
+  strncpy(query, text, FILTER_SIZE - 1);
+  query[FILTER_SIZE - 1] = '\0';
+  current = 0;
+  return true;
+}
+
+
+void Pager::clearFilter()
+{
+  query[0] = '\0';
+  current  = 0;
+}
+
+
+/**
+ * Make page (counted from 0) the current one, if it exists
+ */
+bool Pager::jump(uint16_t page)
+{
+  if (! active() || page >= pages()) return false;
+  current = page;
+  return true;
+}
+
+
+/**
+ * Print the lines of the current page followed by the page number
+ */
+void Pager::show(Print& out) const
+{
+  if (! active()) return;
+
+  uint16_t n     = count();
+  uint32_t first = (uint32_t)current * PAGE_LINES;
+  uint32_t shown = filtered() ? 0 : first; // position of line i among the lines paged
+
+  for (uint32_t i = shown; i < n && shown < first + PAGE_LINES; i++)
+  {
+    if (filtered() && ! matches(i)) continue;
+    if (shown++ < first) continue;
+    line(out, i);
+    out.print("\r\n");
+  }
+  if (filtered())
+  {
+    emit(out, "-- ", hits, " lines containing \"", query, "\" --\r\n");
+  }
+  if (pages() > 1)
+  {
+    emit(out, "-- page ", current + 1, '/', pages(), ", [<] previous [>] next [#] go to --\r\n");
+  }
+}
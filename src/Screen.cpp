@@ -0,0 +1,144 @@
+#include <string.h>
+#include "Format.h"
+#include "Screen.h"
+
+/**
+ * Clear the terminal and start with blank buffers
+ */
+void Screen::begin(Print& out)
+{
+  memset(front, ' ', sizeof(front));
+  clear();
+  emit(out, "\x1b[r\x1b[H\x1b[2J");
+  curRow = curCol = 0;
+}
+
+
+void Screen::end(Print& out)
+{
+  emit(out, "\x1b[H\x1b[2J");
+}
+
+
+/**
+ * Blank the back buffer before drawing the next frame
+ */
+void Screen::clear()
+{
+  memset(back, ' ', sizeof(back));
+}
+
+
+void Screen::put(uint8_t row, uint8_t col, char c)
+{
+  if (row < SCREEN_ROWS && col < SCREEN_COLS) back[row][col] = c;
+}
+
+
+/**
+ * Position the cursor with the shortest sequence
+ */
+void Screen::moveTo(Print& out, uint8_t row, uint8_t col)
+{
+  if (row == curRow && col == curCol) return;
+  if (row == curRow && col > curCol && col - curCol <= 4)
+  {
+    // rewriting the cells in between is shorter than a cursor movement
+    out.write((const uint8_t*)&front[row][curCol], col - curCol);
+  }
+  else if (col == 0 && row == curRow + 1)
+  {
+    emit(out, "\r\n");
+  }
+  else
+  {
+    emit(out, "\x1b[", row + 1, ';', col + 1, 'H');
+  }
+  curRow = row;
+  curCol = col;
+}
+
+
+/**
+ * Send the changed cells and leave the cursor at the given position
+ */
+void Screen::flush(Print& out, uint8_t cursorRow, uint8_t cursorCol)
+{
+  for (uint8_t r = 0; r < SCREEN_ROWS; r++)
+  {
+    if (memcmp(front[r], back[r], SCREEN_COLS) == 0) continue;
+    for (uint8_t c = 0; c < SCREEN_COLS; c++)
+    {
+      // the bottom right cell is left alone, writing it scrolls some terminals
+      if (front[r][c] == back[r][c] || (r == SCREEN_ROWS - 1 && c == SCREEN_COLS - 1)) continue;
+      moveTo(out, r, c);
+      out.write(back[r][c]);
+      front[r][c] = back[r][c];
+      curCol = (c + 1 < SCREEN_COLS) ? c + 1 : 0xFF; // the cursor may wrap or stay at the margin
+    }
+  }
+  moveTo(out, cursorRow, cursorCol);
+}
+
+
+size_t Region::write(uint8_t c)
+{
+  switch (c)
+  {
+    case '\r': col = 0; break;
+    case '\n': row++; col = 0; break;
+    default:
+      if (row < rows && col < cols) screen.put(top + row, left + col, c);
+      col++;
+  }
+  return 1;
+}
+
+
+void LogPane::clear()
+{
+  memset(lines, 0, sizeof(lines));
+  last = 0;
+  col  = 0;
+}
+
+
+size_t LogPane::write(uint8_t c)
+{
+  if (esc)
+  {
+    // ESC [ parameters final byte, or ESC and a single character
+    if (esc == 1 && c == '[') esc = 2;
+    else if (esc == 1 || (c >= 0x40 && c <= 0x7E)) esc = 0;
+    return 1;
+  }
+  switch (c)
+  {
+    case 0x1B: esc = 1; break;
+    case '\r': col = 0; break;
+    case '\b': if (col > 0) col--; break;
+    case '\n':
+      last = (last + 1) % LOG_ROWS;
+      memset(lines[last], 0, LOG_COLS + 1);
+      col = 0;
+      break;
+    default:
+      if (c < ' ' || col >= LOG_COLS) break;
+      // fill a gap left by carriage return or backspace
+      for (uint8_t i = strlen(lines[last]); i < col; i++) lines[last][i] = ' ';
+      lines[last][col++] = c;
+  }
+  return 1;
+}
+
+
+/**
+ * Print the lines, oldest first
+ */
+void LogPane::draw(Print& out) const
+{
+  for (uint8_t i = 1; i <= LOG_ROWS; i++)
+  {
+    emit(out, lines[(last + i) % LOG_ROWS], "\r\n");
+  }
+}
@@ -0,0 +1,425 @@
+#include "Session.h"
+
+enum : char { CTRL_C = 0x03, BS = 0x08, XON = 0x11, XOFF = 0x13, ESC = 0x1B, DEL = 0x7F };
+
+
+/**
+ * Start a session on io with nothing left over from the one before
+ */
+void Session::attach(Stream* io)
+{
+  this->io     = io;
+  pending      = nullptr;
+  len          = 0;
+  esc          = 0;
+  historyCount = 0;
+  historyPos   = 0;
+  outHead      = 0;
+  outCount     = 0;
+  txPaused     = false;
+  rxPaused     = false;
+  xonxoff      = false;
+  json         = false;
+  escape       = false;
+  sink         = nullptr;
+  tap          = nullptr;
+  edited       = nullptr;
+  pager        = {};
+  status       = {};
+}
+
+
+void Session::detach()
+{
+  io = nullptr;
+}
+
+
+/**
+ * Show the prompt and pass the next line entered to handler. If given, 
+ * edited sees the partial line after every keystroke.
+ */
+void Session::ask(const char* prompt, LineHandler handler, LineHandler edited)
+{
+  if (! json) print(prompt);
+  pending      = handler;
+  this->edited = edited;
+  len        = 0;
+  historyPos = 0;
+}
+
+
+/**
+ * Turn software flow control on or off. Turning it off releases both directions.
+ */
+void Session::setFlowControl(bool on)
+{
+  if (! on && rxPaused) io->write(XON);
+  xonxoff  = on;
+  txPaused = false;
+  rxPaused = false;
+}
+
+
+/**
+ * Take XON and XOFF sent by the peer. Returns true if c was one of them.
+ */
+bool Session::flowChar(int c)
+{
+  if (! xonxoff || (c != XON && c != XOFF)) return false;
+  txPaused = (c == XOFF);
+  return true;
+}
+
+
+/**
+ * Ask the peer to pause while the receive buffer is filling up
+ */
+void Session::throttle()
+{
+  if (! xonxoff) return;
+
+  int waiting = io->available();
+  if (! rxPaused && waiting >= RX_HIGH)
+  {
+    io->write(XOFF);
+    rxPaused = true;
+  }
+  else if (rxPaused && waiting <= RX_LOW)
+  {
+    io->write(XON);
+    rxPaused = false;
+  }
+}
+
+
+/**
+ * Pass line to the pending handler as if it had been typed
+ */
+void Session::answer(const char* line)
+{
+  LineHandler handler = pending;
+
+  pending = nullptr;
+  len     = 0;
+  if (handler == nullptr) return;
+  if (tap) tap(line);
+  handler(line);
+}
+
+
+/**
+ * Drop the pending input without calling its handler
+ */
+void Session::cancel()
+{
+  pending = nullptr;
+  len     = 0;
+}
+
+
+/**
+ * Process the input received so far. Returns a command key to be 
+ * dispatched or -1. At most one key or one line is handled per call, 
+ * which gives every session a fair share of the loop.
+ */
+int Session::step()
+{
+  while (io->available())
+  {
+    int c = io->read();
+
+    if (c < 0) break;
+    if (flowChar(c)) continue;
+    if (esc == 1)
+    {
+      esc = (c == '[') ? 2 : 0;
+      continue;
+    }
+    if (esc == 2)
+    {
+      esc = 0;
+      if (pending && c == 'A') recall(1);
+      if (pending && c == 'B') recall(-1);
+      continue;
+    }
+    if (c == ESC)
+    {
+      esc = 1;
+      continue;
+    }
+    if (pending == nullptr)
+    {
+      if (c == '\r' || c == '\n' || c == '\0') continue;
+      throttle();
+      return c;
+    }
+    if (input(c)) break;
+  }
+  throttle();
+  return -1;
+}
+
+
+/**
+ * Edit the line with the character c. Returns true when the line was 
+ * completed and handed over.
+ */
+bool Session::input(char c)
+{
+  switch (c)
+  {
+    case CTRL_C:
+      len = 0;
+      if (json) return false;  // drop the partial request, the next one is still expected
+      pending = nullptr;
+      print("^C");
+      return true;
+    case BS:
+    case DEL:
+      if (len > 0)
+      {
+        len--;
+        if (! json) print("\b \b");
+        notify();
+      }
+      return false;
+    case '\r':
+    case '\n':
+      // an empty line is ignored, as it is most likely the line end sent after the command key
+      if (len == 0) return false;
+      line[len] = '\0';
+      memcpy(history[historyNext], line, len + 1);
+      historyNext = (historyNext + 1) % HISTORY_SIZE;
+      if (historyCount < HISTORY_SIZE) historyCount++;
+      if (! json) print("\r\n");
+      {
+        LineHandler handler = pending;
+        pending = nullptr;   // the handler may ask again
+        len     = 0;
+        if (tap) tap(line);
+        handler(line);
+      }
+      return true;
+    default:
+      if (isprint((unsigned char)c) && len < LINE_SIZE - 1)
+      {
+        line[len++] = c;
+        if (! json) write(c);
+        notify();
+      }
+      return false;
+  }
+}
+
+
+/**
+ * Replace the line with an older (step 1) or newer (step -1) line from the history
+ */
+void Session::recall(int8_t step)
+{
+  int pos = historyPos + step;
+
+  if (pos < 0 || pos > historyCount) return;
+  historyPos = pos;
+  erase();
+  if (pos == 0)
+  {
+    notify();
+    return;
+  }
+  strcpy(line, history[(historyNext + HISTORY_SIZE - pos) % HISTORY_SIZE]);
+  len = strlen(line);
+  if (! json) print(line);
+  notify();
+}
+
+
+/**
+ * Show the partial line to the edit handler
+ */
+void Session::notify()
+{
+  if (edited == nullptr) return;
+  line[len] = '\0';
+  edited(line);
+}
+
+
+/**
+ * Remove the echoed line from the terminal
+ */
+void Session::erase()
+{
+  while (len > 0)
+  {
+    len--;
+    if (! json) print("\b \b");
+  }
+}
+
+
+/**
+ * Send as much of the output queue as the transport takes without blocking
+ */
+void Session::pump()
+{
+  if (txPaused) return;
+
+  int room = io->availableForWrite();
+
+  while (outCount > 0 && room > 0)
+  {
+    size_t chunk = contiguous();
+    if (chunk > (size_t)room) chunk = room;
+    size_t sent = io->write(out + outHead, chunk);
+    if (sent == 0) break;
+    outHead   = (outHead + sent) % OUT_SIZE;
+    outCount -= sent;
+    room     -= sent;
+  }
+}
+
+
+/**
+ * Send the whole output queue, waiting for the transport if necessary
+ */
+void Session::drain()
+{
+  waitForXon();
+  while (outCount > 0)
+  {
+    size_t sent = io->write(out + outHead, contiguous());
+    if (sent == 0)
+    {
+      outCount = 0; // transport is gone, drop the output
+      break;
+    }
+    outHead   = (outHead + sent) % OUT_SIZE;
+    outCount -= sent;
+  }
+}
+
+
+/**
+ * Wait until the peer sends XON, but not longer than XOFF_TIMEOUT. Only 
+ * flow control characters are taken from the input, other input ends 
+ * the wait as the peer is obviously not paused.
+ */
+void Session::waitForXon()
+{
+  uint32_t start = millis();
+
+  while (txPaused && millis() - start < XOFF_TIMEOUT)
+  {
+    if (io->available())
+    {
+      if (! flowChar(io->peek())) break;
+      io->read();
+    }
+    yield();
+  }
+  txPaused = false;
+}
+
+
+/**
+ * Number of queued bytes up to the end of the buffer
+ */
+size_t Session::contiguous() const
+{
+  return outHead + outCount > OUT_SIZE ? OUT_SIZE - outHead : outCount;
+}
+
+
+int Session::available()
+{
+  return io->available();
+}
+
+
+int Session::read()
+{
+  return io->read();
+}
+
+
+int Session::peek()
+{
+  return io->peek();
+}
+
+
+size_t Session::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+
+/**
+ * Queue the output, escaped if it goes into a JSON string
+ */
+size_t Session::write(const uint8_t* buf, size_t size)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  if (sink) return sink->write(buf, size);
+  if (! escape)
+  {
+    queue(buf, size);
+    return size;
+  }
+  for (size_t i = 0; i < size; i++)
+  {
+    uint8_t c = buf[i];
+    if (c == '"' || c == '\\')
+    {
+      const uint8_t seq[] = { '\\', c };
+      queue(seq, sizeof(seq));
+    }
+    else if (c < 0x20)
+    {
+      const uint8_t seq[] = { '\\', 'u', '0', '0', (uint8_t)hex[c >> 4], (uint8_t)hex[c & 15] };
+      queue(seq, sizeof(seq));
+    }
+    else
+    {
+      queue(&c, 1);
+    }
+  }
+  return size;
+}
+
+
+/**
+ * Append to the output queue. A full queue is sent first, so nothing gets 
+ * lost when an action writes more than the queue holds.
+ */
+void Session::queue(const uint8_t* buf, size_t size)
+{
+  size_t done = 0;
+
+  while (done < size)
+  {
+    if (outCount == OUT_SIZE) drain();
+    uint16_t tail  = (outHead + outCount) % OUT_SIZE;
+    size_t   chunk = tail >= outHead ? OUT_SIZE - tail : outHead - tail;
+    if (chunk > size - done) chunk = size - done;
+    memcpy(out + tail, buf + done, chunk);
+    outCount += chunk;
+    done     += chunk;
+  }
+}
+
+
+int Session::availableForWrite()
+{
+  return OUT_SIZE - outCount;
+}
+
+
+void Session::flush()
+{
+  drain();
+  io->flush();
+}
@@ -0,0 +1,33 @@
+#include "StackProbe.h"
+
+static constexpr uint8_t PAINT = 0xA5;
+
+// The region is deliberately written without being read and read without 
+// being written, what the compiler rightly considers suspicious elsewhere
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/**
+ * The region lies in the frame of this function, which after the return 
+ * is the unused stack below the caller
+ */
+void __attribute__((noinline)) stackPaint()
+{
+  volatile uint8_t region[STACK_PROBE_DEPTH];
+
+  for (size_t i = 0; i < STACK_PROBE_DEPTH; i++) region[i] = PAINT;
+}
+
+
+/**
+ * Reads back the same region left over from stackPaint(). The stack grows 
+ * downwards, so the untouched bytes are found at the low end.
+ */
+uint16_t __attribute__((noinline)) stackMeasure()
+{
+  volatile uint8_t region[STACK_PROBE_DEPTH];
+  size_t untouched = 0;
+
+  while (untouched < STACK_PROBE_DEPTH && region[untouched] == PAINT) untouched++;
+  return STACK_PROBE_DEPTH - untouched;
+}
@@ -0,0 +1,56 @@
+#include <string.h>
+#include "Format.h"
+#include "StatusLine.h"
+
+
+/**
+ * Reserve the top line and update it every period ms
+ */
+void StatusLine::begin(Print& out, uint16_t period)
+{
+  this->period = period;
+  memset(shown, 0, sizeof(shown));  // forces a full draw
+  // scroll below the top line only, which homes the cursor, so move it to the bottom
+  emit(out, "\x1b[2;", TERM_ROWS, "r\x1b[", TERM_ROWS, ";1H");
+}
+
+
+/**
+ * Give the top line back to the scrolling region
+ */
+void StatusLine::end(Print& out)
+{
+  period = 0;
+  emit(out, "\x1b""7\x1b[1;1H\x1b[2K\x1b[r\x1b""8");
+}
+
+
+bool StatusLine::due(uint32_t now)
+{
+  if (! active() || now - last < period) return false;
+  last = now;
+  return true;
+}
+
+
+/**
+ * Show text in field i, sending only the part from the first change on
+ */
+void StatusLine::field(Print& out, uint8_t i, const char* text)
+{
+  char    padded[STATUS_WIDTH + 1];
+  uint8_t from, to;
+
+  memset(padded, ' ', STATUS_WIDTH);
+  padded[STATUS_WIDTH] = '\0';
+  memcpy(padded, text, strnlen(text, STATUS_WIDTH));
+
+  for (from = 0; from < STATUS_WIDTH && padded[from] == shown[i][from]; from++) {}
+  if (from == STATUS_WIDTH) return;
+  for (to = STATUS_WIDTH; padded[to - 1] == shown[i][to - 1]; to--) {}
+
+  emit(out, "\x1b""7\x1b[1;", i * STATUS_WIDTH + from + 1, 'H');
+  out.write((const uint8_t*)padded + from, to - from);
+  emit(out, "\x1b""8");
+  memcpy(shown[i], padded, sizeof(padded));
+}
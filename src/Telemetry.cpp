@@ -0,0 +1,91 @@
+#include "Crc16.h"
+#include "Telemetry.h"
+
+// Analog inputs read into the channels
+#if defined(ESP32)
+static const uint8_t pins[TELEMETRY_CHANNELS] = { 36, 39, 34, 35 };
+#elif defined(ESP8266)
+static const uint8_t pins[TELEMETRY_CHANNELS] = { A0, A0, A0, A0 };
+#else
+static const uint8_t pins[TELEMETRY_CHANNELS] = { A0, A1, A2, A3 };
+#endif
+
+
+/**
+ * Send rate frames per second to out
+ */
+void Telemetry::start(Print* out, uint16_t rate)
+{
+  this->out = out;
+  period  = 1000000UL / rate;
+  due     = micros();
+  seq     = 0;
+  head    = 0;
+  count   = 0;
+  offset  = 0;
+  sent    = 0;
+  dropped = 0;
+}
+
+
+void Telemetry::stop()
+{
+  out = nullptr;
+}
+
+
+void Telemetry::sample(TelemetryFrame& frame)
+{
+  frame.sync[0] = 0xA5;
+  frame.sync[1] = 0x5A;
+  frame.seq     = seq++;
+  frame.micros  = micros();
+  for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++) frame.channel[i] = analogRead(pins[i]);
+  frame.crc     = crc16((const uint8_t*)&frame.seq, offsetof(TelemetryFrame, crc) - offsetof(TelemetryFrame, seq));
+}
+
+
+/**
+ * Take a sample when it is due and send what the transport accepts
+ */
+void Telemetry::poll()
+{
+  if (! active()) return;
+
+  uint32_t now = micros();
+  if ((int32_t)(now - due) >= 0)
+  {
+    uint32_t late = (now - due) / period;  // frames missed while the loop was blocked
+    dropped += late;
+    seq     += late;
+    due     += (late + 1) * period;
+    if (count == 2)
+    {
+      dropped++;
+      seq++;
+    }
+    else
+    {
+      sample(frames[(head + count) % 2]);
+      count++;
+    }
+  }
+
+  int room = out->availableForWrite();
+  while (count > 0 && room > 0)
+  {
+    uint8_t chunk = sizeof(TelemetryFrame) - offset;
+    if (chunk > room) chunk = room;
+    size_t n = out->write((const uint8_t*)&frames[head] + offset, chunk);
+    if (n == 0) break;
+    offset += n;
+    room   -= n;
+    if (offset == sizeof(TelemetryFrame))
+    {
+      offset = 0;
+      head  ^= 1;
+      count--;
+      sent++;
+    }
+  }
+}
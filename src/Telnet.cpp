@@ -0,0 +1,114 @@
+#include "Telnet.h"
+
+#if HAS_TELNET
+#if defined(ESP32)
+#include <lwip/sockets.h>
+#endif
+
+/**
+ * Take over the client waiting on server, dropping the current one
+ */
+void TelnetStream::accept(WiFiServer& server)
+{
+  if (client) client.stop();
+#if defined(ESP32)
+  client = server.available();
+#else
+  client = server.accept();
+#endif
+  client.setNoDelay(true);
+  filter.reset();
+  next = -1;
+
+  // the server echoes and the client sends each key without waiting for return
+  const uint8_t charMode[] =
+  {
+    TelnetFilter::IAC, TelnetFilter::WILL, TelnetFilter::OPT_ECHO, 
+    TelnetFilter::IAC, TelnetFilter::WILL, TelnetFilter::OPT_SGA
+  };
+  client.write(charMode, sizeof(charMode));
+}
+
+
+bool TelnetStream::connected()
+{
+  return client.connected();
+}
+
+
+/**
+ * Read ahead the next data byte, skipping over option negotiation. Only 
+ * bytes already received are read, a command split between segments is 
+ * completed by a later call.
+ */
+bool TelnetStream::fill()
+{
+  while (next < 0 && client.available())
+  {
+    int c = client.read();
+    if (c >= 0) next = filter.take(c);
+  }
+  return next >= 0;
+}
+
+
+int TelnetStream::available()
+{
+  return fill() ? 1 + client.available() : 0;
+}
+
+
+int TelnetStream::read()
+{
+  int c = fill() ? next : -1;
+  next = -1;
+  return c;
+}
+
+
+int TelnetStream::peek()
+{
+  return fill() ? next : -1;
+}
+
+
+size_t TelnetStream::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+
+size_t TelnetStream::write(const uint8_t* buf, size_t size)
+{
+  return client.connected() ? client.write(buf, size) : 0;
+}
+
+
+int TelnetStream::availableForWrite()
+{
+#if defined(ESP32)
+  // WiFiClient of the ESP32 does not report its free send buffer. lwIP keeps
+  // the socket writable only while more than TCP_SNDLOWAT bytes are free, 
+  // which is at least one segment, and write() would block otherwise.
+  int fd = client.fd();
+
+  if (fd < 0 || ! client.connected()) return 0;
+
+  fd_set  writable;
+  timeval none = { 0, 0 };
+
+  FD_ZERO(&writable);
+  FD_SET(fd, &writable);
+  return select(fd + 1, nullptr, &writable, nullptr, &none) > 0 ? TCP_MSS : 0;
+#else
+  return client.connected() ? client.availableForWrite() : 0;
+#endif
+}
+
+
+void TelnetStream::flush()
+{
+  client.flush();
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "TelnetFilter.h"
+
+/**
+ * Take the next byte from the client. Returns the data byte it stands for, 
+ * or -1 if it is part of a command.
+ */
+int TelnetFilter::take(uint8_t c)
+{
+  switch (state)
+  {
+    case Data:
+      if (c != IAC) return c;
+      state = Command;
+      return -1;
+    case Command:
+      switch (c)
+      {
+        case IAC:  // escaped 0xFF is data
+          state = Data;
+          return c;
+        case WILL: case WONT: case DO: case DONT:
+          state = Option;
+          return -1;
+        case SB:   // skip the subnegotiation up to IAC SE
+          state = Sub;
+          return -1;
+        default:
+          state = Data;
+          return -1;
+      }
+    case Option:   // the option of WILL, WONT, DO or DONT
+      state = Data;
+      return -1;
+    case Sub:
+      if (c == IAC) state = SubIac;
+      return -1;
+    case SubIac:
+      state = (c == SE) ? Data : Sub;
+      return -1;
+  }
+  return -1;
+}
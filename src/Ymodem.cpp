@@ -0,0 +1,399 @@
+#include "Ymodem.h"
+#if HAS_YMODEM
+#include "Crc16.h"
+
+enum : uint8_t { SOH = 0x01, STX = 0x02, EOT = 0x04, ACK = 0x06, NAK = 0x15, CAN = 0x18, CRC = 'C', PAD = 0x1A };
+
+constexpr uint16_t BYTE_TIMEOUT  = 1000;   // ms within a block
+constexpr uint16_t START_PERIOD  = 1000;   // ms between the C inviting the sender
+constexpr uint8_t  START_TRIES   = 60;     // the user has a minute to start the sender
+constexpr uint16_t ACK_TIMEOUT   = 10000;  // ms the sender waits for an answer
+
+
+static bool mount()
+{
+#if defined(ESP32)
+  return LittleFS.begin(true);  // format a partition that never held a file system
+#else
+  return LittleFS.begin();
+#endif
+}
+
+
+void Ymodem::begin(Stream* io, State state)
+{
+  this->io = io;
+  this->state = state;
+  phase   = Header;
+  retries = 0;
+  seq     = 0;
+  cans    = 0;
+  pos     = 0;
+  files   = 0;
+  bytes   = 0;
+  ok      = false;
+  started = millis();
+  timer   = started - START_PERIOD;  // invite at once
+}
+
+
+/**
+ * Wait for the host to send files and store them
+ */
+bool Ymodem::receive(Stream* io)
+{
+  if (! mount()) return false;
+  sending = false;
+  begin(io, Start);
+  return true;
+}
+
+
+/**
+ * Send the file at path to the host
+ */
+bool Ymodem::send(Stream* io, const char* path)
+{
+  if (! mount() || ! (file = LittleFS.open(path, "r"))) return false;
+
+  const char* name = strrchr(path, '/');
+  name = name ? name + 1 : path;
+
+  sending = true;
+  begin(io, Start);
+  remaining = file.size();
+  size_t n = strnlen(name, YMODEM_NAME);
+  memset(block + 3, 0, 128);
+  memcpy(block + 3, name, n);
+  ultoa(remaining, (char*)block + 3 + n + 1, 10);
+  return true;
+}
+
+
+void Ymodem::finish(bool ok)
+{
+  if (file) file.close();
+  elapsed  = millis() - started;
+  this->ok = ok;
+  io = nullptr;
+}
+
+
+void Ymodem::abort()
+{
+  const uint8_t cancel[] = { CAN, CAN, CAN, CAN, CAN };
+  io->write(cancel, sizeof(cancel));
+  finish(false);
+}
+
+
+void Ymodem::control(uint8_t c)
+{
+  io->write(c);
+  timer = millis();
+}
+
+
+/**
+ * Drive the transfer with the bytes arrived and the time passed
+ */
+void Ymodem::poll()
+{
+  if (! active()) return;
+
+  if (state == Sending) txPump();
+  while (active() && io->available() && state != Sending)
+  {
+    uint8_t c = io->read();
+    if (sending) txByte(c);
+    else         rxByte(c);
+  }
+  if (! active()) return;
+
+  uint32_t idle = millis() - timer;
+  switch (state)
+  {
+    case Start:
+      if (sending && idle >= START_PERIOD * START_TRIES) finish(false);
+      if (! sending && idle >= START_PERIOD)
+      {
+        // C until the first block of a file arrived, then NAK for a lost block
+        bool first = phase == Header || seq == 1;
+        if (++retries > (first ? START_TRIES : YMODEM_RETRIES)) abort();
+        else control(first ? CRC : NAK);
+      }
+      break;
+    case Block:
+      if (idle < BYTE_TIMEOUT) break;
+      pos = 0;
+      if (++retries > YMODEM_RETRIES) abort();
+      else control(NAK);
+      break;
+    case WaitAck:
+      if (idle < ACK_TIMEOUT) break;
+      if (++retries > YMODEM_RETRIES) abort();
+      else txNext();  // send the block once more
+      break;
+    default:
+      break;
+  }
+}
+
+
+// ---- Receiver ----
+
+void Ymodem::rxByte(uint8_t c)
+{
+  if (pos == 0)
+  {
+    switch (c)
+    {
+      case SOH:
+      case STX:
+        length = 3 + (c == SOH ? 128 : YMODEM_BLOCK) + 2;
+        break;
+      case EOT:
+        if (phase == Header)
+        {
+          control(ACK);  // a repeated EOT, the file is already closed
+          return;
+        }
+        // the first EOT is answered with NAK to make sure it is no line noise
+        if (phase != Eot)
+        {
+          phase = Eot;
+          control(NAK);
+          return;
+        }
+        file.close();
+        files++;
+        control(ACK);
+        control(CRC);  // ask for the header of the next file
+        phase = Header;
+        seq   = 0;
+        return;
+      case CAN:
+        if (++cans >= 2) finish(false);
+        return;
+      default:
+        return;     // noise between blocks
+    }
+    cans  = 0;
+    state = Block;
+  }
+  block[pos++] = c;
+  timer = millis();
+  if (pos == length) rxBlock();
+}
+
+
+void Ymodem::rxBlock()
+{
+  uint16_t size = length - 5;
+  uint8_t* data = block + 3;
+  uint16_t crc  = block[length - 2] << 8 | block[length - 1];
+
+  pos   = 0;
+  state = Start;
+  if ((uint8_t)(block[1] ^ block[2]) != 0xFF || crc16(data, size) != crc)
+  {
+    if (++retries > YMODEM_RETRIES) abort();
+    else control(NAK);
+    return;
+  }
+  retries = 0;
+  timer   = millis();
+
+  if (block[1] == (uint8_t)(seq - 1) && phase != Header)
+  {
+    control(ACK);   // our ACK got lost, the sender repeats the block
+    return;
+  }
+  if (block[1] != seq)
+  {
+    abort();
+    return;
+  }
+
+  if (phase == Header)
+  {
+    if (data[0] == 0)  // an empty name ends the batch
+    {
+      control(ACK);
+      finish(true);
+      return;
+    }
+    if (! rxHeader())
+    {
+      abort();
+      return;
+    }
+    control(ACK);
+    control(CRC);
+  }
+  else
+  {
+    if (size > remaining) size = remaining;  // drop the padding
+    if (file.write(data, size) != size)
+    {
+      abort();   // file system full
+      return;
+    }
+    remaining -= size;
+    bytes += size;
+    control(ACK);
+  }
+  phase = Data;
+  seq++;
+}
+
+
+/**
+ * Open the file named in block 0: name, NUL, size in decimal, ...
+ */
+bool Ymodem::rxHeader()
+{
+  const char* name = (const char*)block + 3;
+  char        path[YMODEM_NAME + 1] = "/";
+  const char* base = strrchr(name, '/');
+  const char* size = name + strlen(name) + 1;
+
+  strncat(path, base ? base + 1 : name, YMODEM_NAME - 1);
+  remaining = isdigit(*size) ? strtoul(size, nullptr, 10) : UINT32_MAX;
+  file = LittleFS.open(path, "w");
+  return file;
+}
+
+
+// ---- Sender ----
+
+void Ymodem::txByte(uint8_t c)
+{
+  if (c == CAN)
+  {
+    if (++cans >= 2) finish(false);
+    return;
+  }
+  cans = 0;
+
+  if (state == Start)
+  {
+    if (c != CRC) return;
+    retries = 0;
+    if (phase == Data) txBlock(YMODEM_BLOCK);     // first block after the header
+    else txNext();
+    return;
+  }
+  if (state != WaitAck) return;
+
+  if (c == NAK || (c == CRC && phase == Header))
+  {
+    if (++retries > YMODEM_RETRIES) abort();
+    else txNext();
+    return;
+  }
+  if (c != ACK) return;
+
+  retries = 0;
+  switch (phase)
+  {
+    case Header:
+      phase = Data;
+      seq   = 1;
+      state = Start;   // the receiver asks for the data with C
+      break;
+    case Data:
+      seq++;
+      txBlock(YMODEM_BLOCK);
+      break;
+    case Eot:
+      phase = Final;
+      seq   = 0;
+      memset(block + 3, 0, 128);
+      state = Start;   // the receiver asks for the next header
+      break;
+    case Final:
+      finish(true);
+      break;
+  }
+}
+
+
+/**
+ * Read the next block of the file into the buffer and send it, or send EOT at the end
+ */
+void Ymodem::txBlock(uint16_t size)
+{
+  uint16_t n = file.read(block + 3, size);
+
+  if (n == 0)
+  {
+    file.close();
+    files++;
+    phase  = Eot;
+    length = 0;
+    txNext();
+    return;
+  }
+  if (n <= 128) size = 128;  // a short tail goes into a small block
+  memset(block + 3 + n, PAD, size - n);
+  bytes += n;
+  block[0] = size == 128 ? SOH : STX;
+  block[1] = seq;
+  block[2] = ~seq;
+  uint16_t crc = crc16(block + 3, size);
+  block[3 + size] = crc >> 8;
+  block[4 + size] = crc;
+  length = size + 5;
+  txNext();
+}
+
+
+/**
+ * Send the block in the buffer, the header block or EOT
+ */
+void Ymodem::txNext()
+{
+  if (phase == Eot)
+  {
+    control(EOT);
+    state = WaitAck;
+    return;
+  }
+  if (phase == Header || phase == Final)
+  {
+    block[0] = SOH;
+    block[1] = 0;
+    block[2] = 0xFF;
+    uint16_t crc = crc16(block + 3, 128);
+    block[131] = crc >> 8;
+    block[132] = crc;
+    length = 133;
+  }
+  pos   = 0;
+  state = Sending;
+  txPump();
+}
+
+
+/**
+ * Hand the block to the transport as far as it takes it without blocking
+ */
+void Ymodem::txPump()
+{
+  int room = io->availableForWrite();
+
+  while (pos < length && room > 0)
+  {
+    uint16_t chunk = length - pos;
+    if (chunk > room) chunk = room;
+    size_t n = io->write(block + pos, chunk);
+    if (n == 0) break;
+    pos  += n;
+    room -= n;
+  }
+  if (pos < length) return;
+  state = WaitAck;
+  timer = millis();
+}
+#endif
@@ -8,110 +8,339 @@
  *                - floats
  *                - text
  *              Numbers are parsed into variables of type integer or float. 
- *              Reading of keystrokes ends when the time between keystrokes is
- *              greater than the time set in milliseconds with Serial.setTimeout(ms).
- *              The default timeout is 1000 ms
+ *              They can be given as expressions like (0x10 + i) << 2, where
+ *              i, f and baud stand for the last integer, the last float and
+ *              the baud rate.
+ *              Values are typed on an echoed line, which is ended with return.
+ *              Backspace edits the line, the arrow keys recall earlier lines
+ *              and Ctrl-C cancels the input.
+ *              On ESP32 and ESP8266 the menu is also served over telnet (port 23)
+ *              when WIFI_SSID and WIFI_PASS are given as build flags. Every 
+ *              connection gets its own session with its own input and output.
+ *              Machine clients switch to JSON mode with [j] and then send one 
+ *              request per line, e.g. {"cmd":"f","arg":3.14}, and receive
+ *              {"cmd":"f","text":"3.140000 was entered ","ok":true,"value":3.140000}
+ *              Edges on GPIO pins trigger menu actions as if their key was pressed.
+ *              On ESP32 and ESP8266 files are uploaded to and downloaded from
+ *              LittleFS with YMODEM over the serial line.
  * 
- * Board        ESP32
+ * Board        ESP32, ESP8266 (d1_mini), Arduino Uno
  *
  * Remarks      Pros: + Simple and well structured
  *                    + Easy to understand
  *                    + Input of integers, floats and text
  *                    + Execut user defined actions
- *              Cons: - The input is hidden, which means that the entered value can  
- *                      only be displayed after the timeout of the serial interface.
- *                    - The main loop is blocked as long as numbers or text are entered.      
+ *                    + The main loop keeps running while numbers or text are entered
  *
  * References   https://www.arduino.cc/reference/en/language/functions/communication/serial/
  */
 
 #include <Arduino.h>
+#include <Menu.h>
+#include "Board.h"
+#include "CliParse.h"
+#include "Cycles.h"
+#include "EdgeTrigger.h"
+#include "Expr.h"
+#include "Format.h"
+#include "HexDump.h"
+#include "JsonLine.h"
+#include "Macro.h"
+#include "MemInfo.h"
+#include "Profile.h"
+#include "Screen.h"
+#include "Session.h"
+#include "StackProbe.h"
+#include "Telemetry.h"
+#include "Telnet.h"
+#include "Ymodem.h"
 
 // Clear the current line with a carriage return, then printing 80 blanks 
 // followed by another carriage return to reposition the cursor on line beginning
-#define CLEAR_LINE     Serial.printf("\r%*c\r", 80, ' ')
+#define CLEAR_LINE     emit(*session, '\r', repeat(' ', 80), '\r')
 
-// Definition of the action and the menuitem
-using Action   = void(&)(const char*);
-using MenuItem = struct mi{ const char key; const char* txt; const char* arg; Action action; };
 
+// Session 0 is served on Serial, the others on telnet connections
+#if HAS_TELNET
+constexpr uint8_t MAX_SESSIONS = FEATURE_TELNET ? 4 : 1;
+WiFiServer   telnetServer(23);
+TelnetStream telnet[FEATURE_TELNET ? MAX_SESSIONS - 1 : 1];
+#ifndef WIFI_PASS
+#define WIFI_PASS ""
+#endif
+#else
+constexpr uint8_t MAX_SESSIONS = 1;
+#endif
+Session  sessions[MAX_SESSIONS];
+Session* session = &sessions[0]; // the session whose input is being handled
 
+// Baud rate of Serial. A change is kept only when the client confirms it
+// by sending "ok" at the new rate before baudDeadline.
+#if defined(__AVR__)
+constexpr uint32_t MAX_BAUD = 1000000;
+#elif defined(ESP8266)
+constexpr uint32_t MAX_BAUD = 921600;
+#else
+constexpr uint32_t MAX_BAUD = 2000000;
+#endif
+constexpr uint32_t BAUD_PROBE_MS = 5000;
+uint32_t baudRate = 115200;
+uint32_t baudPrevious;
+uint32_t baudDeadline;  // 0 if no change is waiting for confirmation
+
+bool rtsCts = false;    // hardware flow control on the UART of session 0
 bool heartbeatEnabled = true;
+struct Beat { uint16_t period; uint16_t pulseWidth; };  // ms
+Beat beat = { 1000, 20 };
+float setpoint = 20.0;  // temperature set by the typed menuitems
+OutputPin led;
+char lastKey = ' ';    // key of the last dispatched command
+uint32_t loopRate;     // passes through loop() in the last second
+int32_t  lastInteger;  // last values entered, usable in expressions
+double   lastFloat;
+JsonResult result;  // typed result of the action handling a JSON request
+
+// Full screen mode, used by one session at a time
+constexpr uint16_t TUI_PERIOD = 100;  // ms between redraws
+Screen   screen;
+Session* tuiSession = nullptr;
+uint32_t tuiDrawn;
+
+// The log is a Print, which needs a constructor at run time. Created on 
+// first use, it is left out with the full screen mode like the rest.
+LogPane& tuiLog()
+{
+  static LogPane log;
+  return log;
+}
+
+// Keystroke macro, recorded by one session at a time
+Macro    macro;
+Session* macroSession = nullptr;
+
+// Binary telemetry, streamed to one session at a time
+Telemetry telemetry;
+Session*  telemetrySession = nullptr;
+
+// GPIO edges bound to menu keys, their actions run in session 0
+struct EdgeBinding { uint8_t pin; int mode; char key; };
+#if defined(__AVR__)
+constexpr uint8_t EDGE_PIN = 2;  // INT0
+#else
+constexpr uint8_t EDGE_PIN = 0;  // BOOT or FLASH button
+#endif
+const EdgeBinding edgeBindings[] = 
+{
+  { EDGE_PIN, FALLING, 't' },
+};
+constexpr uint8_t nbrEdgeBindings = sizeof(edgeBindings) / sizeof(edgeBindings[0]);
+static_assert(nbrEdgeBindings <= EDGE_BINDINGS, "too many edge bindings");
+
+// YMODEM file transfer, on the serial session only
+#if HAS_YMODEM
+// Created on first use, like the log of the full screen mode
+Ymodem& ymodem()
+{
+  static Ymodem transfer;
+  return transfer;
+}
+#endif
+
+// Hex dump, streamed to one session at a time
+HexDump  hexDump;
+Session* dumpSession = nullptr;
 
 // Forward declaration of menu actions
 void enterFloat(const char*);
 void enterInteger(const char*);
 void enterString(const char*);
+void changeBaudRate(const char*);
+void toggleFlowControl(const char*);
+void toggleJson(const char*);
+void browseStations(const char*);
+void nextPage(const char*);
+void previousPage(const char*);
+void goToPage(const char*);
+void filterList(const char*);
+void setStatusLine(const char*);
+void toggleFullScreen(const char*);
+void toggleRecording(const char*);
+void playMacro(const char*);
+void setTelemetry(const char*);
+void showEdges(const char*);
+void injectEdges(const char*);
+void receiveFiles(const char*);
+void sendFile(const char*);
+void dumpMemory(const char*);
+void runBenchmark(const char*);
 void playRadio(const char* url);
 void setDateTime(const char*);
 void sayHello(const char*);
 void showDateTime(const char*);
+void showMemory(const char*);
 void showMenu(const char*);
+void showPage();
+void dispatch(int);
+uint16_t menuCount();
+void menuLine(Print&, uint16_t);
+void showSessions(const char*);
+void showStackUsage(const char*);
 void toggleHeartbeat(const char*);
 
 
+// Arguments of the typed menuitems
+constexpr uint8_t buttonPin   = EDGE_PIN;
+constexpr float   comfortTemp = 21.5;
+constexpr float   ecoTemp     = 18.0;
+constexpr Beat    normalBeat  = { 1000, 20 };
+constexpr Beat    alarmBeat   = { 250, 125 };
+
+void readPin(uint8_t pin);
+void setSetpoint(float value);
+void setBeat(const Beat& pattern);
+
+
 // Menu definition
-// Each menuitem is composed of a key, a text, an actionargument and an action
-MenuItem menu[] = 
-{
-  { '0', "[0] Klassik Radio",    "http://stream.klassikradio.de/live/mp3-128/stream.klassikradio.de", playRadio },
-  { '1', "[1] SRF1 AG-SO",       "http://stream.srg-ssr.ch/m/regi_ag_so/mp3_128", playRadio },
-  { '2', "[2] SRF2",             "http://stream.srg-ssr.ch/m/drs2/mp3_128", playRadio },
-  { '3', "[3] SRF3",             "http://stream.srg-ssr.ch/m/drs3/mp3_128", playRadio },  
-  { 'h', "[h] Say Hello",        "Guten Tag", sayHello },
-  { 'd', "[d] Set date and time as: yyyy mm dd hh mm ss", "", setDateTime },
-  { 'D', "[D] Show date and time", "", showDateTime },
-  { 'i', "[i] Enter an integer",   "", enterInteger },
-  { 'f', "[f] Enter a float",      "", enterFloat },
-  { 's', "[s] Enter a string",     "", enterString },
-  { 't', "[t] Toggle heartbeat",   "", toggleHeartbeat },
-  { 'S', "[S] Show menu",          "", showMenu },
+// Each menuitem is composed of a key, a text, an actionargument and an action.
+// It is part of the menu from the profile given on, see Profile.h
+struct MenuEntry { Profile profile; MenuItem item; };
+
+constexpr MenuEntry menuEntries[] = 
+{
+  { Minimal,  { '0', "[0] Klassik Radio",    "http://stream.klassikradio.de/live/mp3-128/stream.klassikradio.de", playRadio } },
+  { Minimal,  { '1', "[1] SRF1 AG-SO",       "http://stream.srg-ssr.ch/m/regi_ag_so/mp3_128", playRadio } },
+  { Minimal,  { '2', "[2] SRF2",             "http://stream.srg-ssr.ch/m/drs2/mp3_128", playRadio } },
+  { Minimal,  { '3', "[3] SRF3",             "http://stream.srg-ssr.ch/m/drs3/mp3_128", playRadio } },
+  { Minimal,  { 'h', "[h] Say Hello",        "Guten Tag", sayHello } },
+  { Minimal,  { 'd', "[d] Set date and time as: yyyy mm dd hh mm ss", "", setDateTime } },
+  { Minimal,  { 'D', "[D] Show date and time", "", showDateTime } },
+  { Minimal,  { 'i', "[i] Enter an integer",   "", enterInteger } },
+  { Minimal,  { 'f', "[f] Enter a float",      "", enterFloat } },
+  { Minimal,  { 's', "[s] Enter a string",     "", enterString } },
+  { Minimal,  { 't', "[t] Toggle heartbeat",   "", toggleHeartbeat } },
+  { Standard, { 'n', "[n] Normal heartbeat",   "", call<Beat, normalBeat, setBeat> } },
+  { Standard, { 'a', "[a] Alarm heartbeat",    "", call<Beat, alarmBeat, setBeat> } },
+  { Standard, { 'u', "[u] Comfort setpoint",   "", call<float, comfortTemp, setSetpoint> } },
+  { Standard, { 'U', "[U] Eco setpoint",       "", call<float, ecoTemp, setSetpoint> } },
+  { Standard, { 'p', "[p] Read the button pin", "", call<uint8_t, buttonPin, readPin> } },
+  { Standard, { 'k', "[k] Show stack usage",   "", showStackUsage } },
+  { Standard, { 'm', "[m] Show memory usage",  "", showMemory } },
+  { Standard, { 'w', "[w] Show sessions",      "", showSessions } },
+  { Minimal,  { 'b', "[b] Change baud rate",   "", changeBaudRate } },
+  { Minimal,  { 'F', "[F] Toggle XON/XOFF flow control", "", toggleFlowControl } },
+  { Standard, { 'j', "[j] Toggle JSON mode",   "", toggleJson } },
+  { Standard, { 'g', "[g] Browse generated station list", "", browseStations } },
+  { Standard, { '>', "[>] Next page",          "", nextPage } },
+  { Standard, { '<', "[<] Previous page",      "", previousPage } },
+  { Standard, { '#', "[#] Go to page",         "", goToPage } },
+  { Standard, { '/', "[/] Filter the list",    "", filterList } },
+  { Standard, { 'l', "[l] Set status line period", "", setStatusLine } },
+  { Full,     { 'T', "[T] Toggle full screen mode", "", toggleFullScreen } },
+  { Standard, { 'r', "[r] Start/stop recording a macro", "", toggleRecording } },
+  { Standard, { 'R', "[R] Play the macro",     "", playMacro } },
+  { Full,     { 'B', "[B] Binary telemetry rate", "", setTelemetry } },
+  { Standard, { 'e', "[e] Show edge bindings and latency", "", showEdges } },
+  { Standard, { 'E', "[E] Inject edges",       "", injectEdges } },
+  { Standard, { 'y', "[y] Receive files with YMODEM", "", receiveFiles } },
+  { Standard, { 'Y', "[Y] Send a file with YMODEM", "", sendFile } },
+  { Standard, { 'x', "[x] Hex dump memory or flash", "", dumpMemory } },
+  { Standard, { 'c', "[c] Benchmark the CLI primitives", "", runBenchmark } },
+  { Minimal,  { 'S', "[S] Show menu",          "", showMenu } },
 };
-constexpr uint8_t nbrMenuItems = sizeof(menu) / sizeof(menu[0]);
 
+constexpr uint8_t countMenuItems()
+{
+  uint8_t n = 0;
+  for (const MenuEntry& e : menuEntries) n += e.profile <= PROFILE;
+  return n;
+}
+constexpr uint8_t nbrMenuItems = countMenuItems();
 
-void setDateTime(const char* txt)
+// The menuitems of the profile, selected at compile time. The entries left 
+// out are referred to nowhere else, so their texts and actions are dropped.
+constexpr Menu<nbrMenuItems> selectMenuItems()
+{
+  Menu<nbrMenuItems> selected;
+  for (const MenuEntry& e : menuEntries) if (e.profile <= PROFILE) selected.add(e.item);
+  return selected;
+}
+constexpr Menu<nbrMenuItems> menu = selectMenuItems();
+
+// Peak stack usage in bytes measured for each menuitem, with the diagnostics
+Feature<FEATURE_DIAGNOSTICS, uint16_t[nbrMenuItems], uint16_t[1]> stackPeak;
+
+
+/**
+ * Report the typed result of an action to a JSON client
+ */
+void report(int32_t value)
+{
+  result.type = JsonResult::Integer;
+  result.i    = value;
+}
+
+void report(double value)
+{
+  result.type = JsonResult::Float;
+  result.f    = value;
+}
+
+void report(bool value)
+{
+  result.type = JsonResult::Bool;
+  result.b    = value;
+}
+
+void reportInvalid()
+{
+  result.type = JsonResult::Failed;
+}
+
+
+void onDateTime(const char* line)
 {
- // enter time as: yyyy mo dd hh mm ss
   tm time;
-  int y, m, mday;
-  timeval sec_musec;
-  String str;
-  uint32_t timeout = Serial.getTimeout(); // get the default timeout
-
-  delay(2000);
-  Serial.setTimeout(3 * timeout); // extend timeout to have more time for entering numbers
-  while (Serial.available())
-  {
-    str = Serial.readString();
-  }
-  Serial.setTimeout(timeout); // restore default timeout
-  sscanf(str.c_str(), "%4d%*c%2d%*c%2d%*c%2d%*c%2d%*c%2d", &time.tm_year, &time.tm_mon, &time.tm_mday, 
-                                                           &time.tm_hour, &time.tm_min, &time.tm_sec);
-  time.tm_mon  -= 1;
-  time.tm_year -= 1900;
-
-  sec_musec.tv_sec = mktime(&time);
-  sec_musec.tv_usec= 0;
-  settimeofday(&sec_musec, NULL); // Set the internal RTC of the ESP32
+
+  if (! parseDateTime(line, time))
+  {
+    emit(*session, "Invalid date and time: ", line);
+    reportInvalid();
+    return;
+  }
+
+  rtcSet(time);
   showDateTime("");
 }
 
+/**
+ * Ask date and time as: yyyy mo dd hh mm ss
+ */
+void setDateTime(const char* txt)
+{
+  session->ask("Date and time: ", onDateTime);
+}
+
 void showDateTime(const char* txt)
 {
   tm   rtcTime;
   char buf[60];
   int  bufSize = sizeof(buf);
 
-  getLocalTime(&rtcTime);
+  if (! rtcGet(rtcTime))
+  {
+    session->print("Date and time not set ");
+    reportInvalid();
+    return;
+  }
   strftime(buf, bufSize, "%B %d %Y %T (%A)",  &rtcTime);
-  Serial.printf("%s", buf);
+  session->print(buf);
+  report((int32_t)mktime(&rtcTime));
 }
 
 
 void playRadio(const char* url)
 {
-  Serial.printf("Playing: %s", url);
+  emit(*session, "Playing: ", url);
 }
 
 
@@ -120,59 +349,615 @@ void playRadio(const char* url)
  */
 void sayHello(const char* txt)
 {
-  Serial.print(txt);
+  session->print(txt);
 }
 
 
 /**
- * Ask a integer from user
+ * Values that can be referred to by name in numeric input
  */
-void enterInteger(const char* txt)
+bool lookupVariable(const char* name, uint8_t len, double& value)
+{
+  if (len == 1 && name[0] == 'i')               value = lastInteger;
+  else if (len == 1 && name[0] == 'f')          value = lastFloat;
+  else if (len == 4 && ! strncmp(name, "baud", 4)) value = baudRate;
+  else return false;
+  return true;
+}
+
+/**
+ * The same values in integer input, f only if it is within the range
+ */
+bool lookupInteger(const char* name, uint8_t len, int32_t& value)
+{
+  if (len == 1 && name[0] == 'i')               value = lastInteger;
+  else if (len == 1 && name[0] == 'f' && lastFloat >= INT32_MIN && lastFloat <= INT32_MAX) value = lastFloat;
+  else if (len == 4 && ! strncmp(name, "baud", 4)) value = baudRate;
+  else return false;
+  return true;
+}
+
+
+void onInteger(const char* line)
 {
-  char buf[32];
   int32_t value = 0;
 
-  delay(2000);
-  while (Serial.available())
+  if (! evaluate(line, value, lookupInteger))
   {
-    value = Serial.parseInt();
+    emit(*session, "Not an integer: ", line);
+    reportInvalid();
+    return;
   }
-  snprintf(buf, sizeof(buf), "%d was entered ", value);
-  Serial.print(buf);
+  emit(*session, value, " was entered ");
+  lastInteger = value;
+  report(value);
 }
 
-
 /**
- * Ask a float from user
+ * Ask a integer from user
  */
-void enterFloat(const char* txt)
+void enterInteger(const char* txt)
+{
+  session->ask("Integer: ", onInteger);
+}
+
+
+void onFloat(const char* line)
 {
-  char buf[32];
   double value = 0;
 
-  delay(2000);
-  while (Serial.available())
+  if (! evaluate(line, value, lookupVariable))
   {
-    value = Serial.parseFloat();
+    emit(*session, "Not a float: ", line);
+    reportInvalid();
+    return;
   }
-  snprintf(buf, sizeof(buf), "%f was entered ", value);
-  Serial.print(buf);  
+  emit(*session, fixed(value, 6), " was entered ");
+  lastFloat = value;
+  report(value);
+}
+
+/**
+ * Ask a float from user
+ */
+void enterFloat(const char* txt)
+{
+  session->ask("Float: ", onFloat);
 }
 
 
+void onString(const char* line)
+{
+  session->print(line);
+}
+
 /**
  * Ask a string from user
  */
 void enterString(const char* txt)
 {
-  String str;
-  
-  delay(2000);
-  while (Serial.available())
+  session->ask("Text: ", onString);
+}
+
+
+/**
+ * Switch Serial to another baud rate, waiting for the data sent so far 
+ */
+void switchBaudRate(uint32_t rate)
+{
+  session->flush();
+  uartBaud(rate);
+  baudRate = rate;
+}
+
+
+/**
+ * Go back to the previous baud rate
+ */
+void revertBaudRate()
+{
+  baudDeadline = 0;
+  switchBaudRate(baudPrevious);
+  emit(*session, "\r\nNo confirmation, back to ", baudRate, " baud ");
+}
+
+
+void onBaudProbe(const char* line)
+{
+  if (strcmp(line, "ok") != 0)
+  {
+    revertBaudRate();
+    reportInvalid();
+    return;
+  }
+  baudDeadline = 0;
+  emit(*session, baudRate, " baud confirmed ");
+  report((int32_t)baudRate);
+}
+
+
+void onBaudRate(const char* line)
+{
+  int32_t rate;
+
+  if (! parseInteger(line, rate) || rate < 1200 || (uint32_t)rate > MAX_BAUD)
+  {
+    emit(*session, "Not a baud rate up to ", MAX_BAUD, ": ", line);
+    reportInvalid();
+    return;
+  }
+  emit(*session, "Switching to ", rate, " baud, send ok at the new rate within ", 
+       BAUD_PROBE_MS / 1000, " s\r\n");
+  baudPrevious = baudRate;
+  switchBaudRate(rate);
+  baudDeadline = timeMs() + BAUD_PROBE_MS;
+  if (baudDeadline == 0) baudDeadline = 1;
+  session->ask("", onBaudProbe);
+}
+
+
+/**
+ * Negotiate a new baud rate on the serial session
+ */
+void changeBaudRate(const char* txt)
+{
+  if (session != &sessions[0])
+  {
+    session->print("Only the serial session can change the baud rate ");
+    return;
+  }
+  emit(*session, "Now ", baudRate, " baud, ");
+  session->ask("new rate: ", onBaudRate);
+}
+
+
+/**
+ * Turn software flow control of the own session on or off
+ */
+void toggleFlowControl(const char* txt)
+{
+  session->setFlowControl(! session->flowControl());
+  emit(*session, "XON/XOFF ", session->flowControl() ? "on " : "off ");
+  report(session->flowControl());
+  if (session == &sessions[0] && rtsCts) session->print(", RTS/CTS on ");
+}
+
+
+/**
+ * Update the fields of the status line of the own session
+ */
+void updateStatusLine()
+{
+  char        buf[STATUS_WIDTH + 1];
+  BufferPrint field(buf, sizeof(buf));
+  tm          now;
+  MemSample   mem;
+
+  if (rtcGet(now)) strftime(buf, sizeof(buf), "%T", &now);
+  else strcpy(buf, "--:--:--");
+  session->status.field(*session, 0, buf);
+
+  field.clear();
+  emit(field, "heartbeat ", heartbeatEnabled ? "on" : "off");
+  session->status.field(*session, 1, buf);
+
+  field.clear();
+  emit(field, loopRate, " loops/s");
+  session->status.field(*session, 2, buf);
+
+  memSample(mem, lastKey);
+  field.clear();
+  emit(field, "heap ", mem.freeHeap);
+  session->status.field(*session, 3, buf);
+}
+
+
+void onStatusPeriod(const char* line)
+{
+  int32_t period;
+
+  if (! parseInteger(line, period) || period < 0 || period > 60000)
+  {
+    emit(*session, "Not a period of 0 to 60000 ms: ", line);
+    reportInvalid();
+    return;
+  }
+  if (period == 0) session->status.end(*session);
+  else session->status.begin(*session, period);
+  report(period);
+}
+
+/**
+ * Show a status line on the top of the terminal, updated every period ms
+ */
+void setStatusLine(const char* txt)
+{
+  session->ask("Period in ms (0 = off): ", onStatusPeriod);
+}
+
+
+/**
+ * Draw the full screen: status on top, the browsed list on the left, 
+ * the output of the actions on the right and a hint at the bottom
+ */
+void drawFullScreen()
+{
+  char      buf[12];
+  tm        now;
+  MemSample mem;
+
+  screen.clear();
+  Region top(screen, 0, 0, 1, SCREEN_COLS);
+  if (rtcGet(now)) strftime(buf, sizeof(buf), "%T", &now);
+  else strcpy(buf, "--:--:--");
+  memSample(mem, lastKey);
+  emit(top, " CLI Menu Demo   ", buf, "   heartbeat ", heartbeatEnabled ? "on " : "off",
+       "   ", loopRate, " loops/s   heap ", mem.freeHeap);
+
+  Region list(screen, 1, 0, LOG_ROWS, 40);
+  session->pager.show(list);
+  for (uint8_t r = 1; r <= LOG_ROWS; r++) screen.put(r, 40, '|');
+  Region log(screen, 1, 41, LOG_ROWS, LOG_COLS);
+  tuiLog().draw(log);
+
+  const char* hint = session->asking() ? " Enter the value, return to finish, Ctrl-C to cancel"
+                                       : " Press a key, [T] leaves the full screen mode";
+  Region bottom(screen, SCREEN_ROWS - 1, 0, 1, SCREEN_COLS);
+  bottom.print(hint);
+
+  session->redirect(nullptr);
+  screen.flush(*session, SCREEN_ROWS - 1, strlen(hint));
+  session->redirect(&tuiLog());
+  tuiDrawn = timeMs();
+}
+
+/**
+ * Lay out menu, status and output on the whole terminal. The screen is 
+ * redrawn every TUI_PERIOD ms, sending only the cells that changed.
+ */
+void toggleFullScreen(const char* txt)
+{
+  if (tuiSession == session)
+  {
+    session->redirect(nullptr);
+    screen.end(*session);
+    tuiSession = nullptr;
+    showMenu("");
+    return;
+  }
+  if (tuiSession)
+  {
+    session->print("Another session uses the full screen mode ");
+    reportInvalid();
+    return;
+  }
+  if (session->status.active()) session->status.end(*session);
+  if (! session->pager.active()) session->pager.open(menuCount, menuLine);
+  tuiSession = session;
+  tuiLog().clear();
+  screen.begin(*session);
+  session->redirect(&tuiLog());
+}
+
+
+void onMacroLine(const char* line)
+{
+  macro.line(line);
+}
+
+/**
+ * Record the keys and lines entered on the own session into the macro
+ */
+void toggleRecording(const char* txt)
+{
+  if (macroSession && macroSession != session)
+  {
+    session->print("Another session is recording ");
+    reportInvalid();
+    return;
+  }
+  if (macroSession)
+  {
+    bool kept = macro.stop();
+    macroSession->setTap(nullptr);
+    macroSession = nullptr;
+    if (kept) emit(*session, "Macro of ", macro.size(), " bytes saved ");
+    else emit(*session, "Macro longer than ", MACRO_SIZE, " bytes, dropped ");
+    report(kept);
+    return;
+  }
+  macro.start();
+  macroSession = session;
+  session->setTap(onMacroLine);
+  session->print("Recording, [r] stops ");
+}
+
+
+/**
+ * Replay the macro at full speed, lines are passed directly to the 
+ * action asking for them
+ */
+void playMacro(const char* txt)
+{
+  const uint8_t* p   = macro.data();
+  const uint8_t* end = p + macro.size();
+
+  if (macroSession)
+  {
+    session->print("Stop the recording first ");
+    reportInvalid();
+    return;
+  }
+  if (p == end) session->print("No macro recorded ");
+
+  while (p < end)
+  {
+    if (*p == LINE_MARK)
+    {
+      const char* line = (const char*)p + 1;
+      p = (const uint8_t*)line + strlen(line) + 1;
+      if (session->asking()) session->answer(line);
+    }
+    else
+    {
+      int i = menu.find(*p++);
+      session->print("\r\n");
+      if (i >= 0) dispatch(i);
+    }
+  }
+}
+
+
+void stopTelemetry()
+{
+  telemetry.stop();
+  telemetrySession = nullptr;
+  emit(*session, "\r\nTelemetry stopped, ", telemetry.sent, " frames sent, ", telemetry.dropped, " dropped ");
+  report((int32_t)telemetry.dropped);
+}
+
+
+void onTelemetryRate(const char* line)
+{
+  int32_t rate;
+
+  if (! parseInteger(line, rate) || rate < 0 || rate > 1000)
+  {
+    emit(*session, "Not a rate of 0 to 1000 Hz: ", line);
+    reportInvalid();
+    return;
+  }
+  if (rate == 0)
+  {
+    if (telemetrySession == session) stopTelemetry();
+    return;
+  }
+  emit(*session, "Streaming ", sizeof(TelemetryFrame), " byte frames at ", rate, " Hz, [B] 0 stops\r\n");
+  session->flush();  // no text between the frames
+  telemetrySession = session;
+  telemetry.start(session->transport(), rate);
+}
+
+/**
+ * Stream binary frames with the analog readings at the rate entered
+ */
+void setTelemetry(const char* txt)
+{
+  if (telemetrySession && telemetrySession != session)
+  {
+    session->print("Another session receives the telemetry ");
+    reportInvalid();
+    return;
+  }
+  if (session != &sessions[0])  // telnet would take 0xFF and CR in the frames for commands
+  {
+    session->print("Telemetry runs on the serial session only ");
+    reportInvalid();
+    return;
+  }
+  session->ask("Frames per second (0 = off): ", onTelemetryRate);
+}
+
+
+/**
+ * List the edge bindings and the latency from the edge to the action
+ */
+void showEdges(const char* txt)
+{
+  const EdgeStats& stats = edgeStats();
+
+  for (uint8_t i = 0; i < nbrEdgeBindings; i++)
+  {
+    emit(*session, "Pin ", edgeBindings[i].pin, " -> [", edgeBindings[i].key, "]\r\n");
+  }
+  if (stats.count == 0)
+  {
+    session->print("No edges yet ");
+  }
+  else
+  {
+    emit(*session, stats.count, " edges, latency min ", stats.min, " avg ", stats.total / stats.count, 
+         " max ", stats.max, " us, ", stats.overflows, " lost ");
+  }
+  report((int32_t)stats.count);
+}
+
+
+void onInjectCount(const char* line)
+{
+  int32_t n;
+
+  if (! parseInteger(line, n) || n < 1 || n > 100)
   {
-    str = Serial.readString();
+    emit(*session, "Not a count of 1 to 100: ", line);
+    reportInvalid();
+    return;
   }
-  Serial.print(str);
+  for (int32_t i = 0; i < n; i++) edgeInject(0);
+  emit(*session, n, " edges injected on pin ", edgeBindings[0].pin);
+  report(n);
+}
+
+/**
+ * Simulate edges on the first bound pin, as the interrupt would queue them
+ */
+void injectEdges(const char* txt)
+{
+  session->ask("Number of edges: ", onInjectCount);
+}
+
+
+/**
+ * Tell whether a file transfer can run in the own session
+ */
+bool canTransfer()
+{
+#if HAS_YMODEM
+  if (session == &sessions[0]) return true;
+  session->print("YMODEM runs on the serial session only ");
+#else
+  session->print("No file system on this board ");
+#endif
+  reportInvalid();
+  return false;
+}
+
+
+/**
+ * Store the files uploaded by the host in LittleFS
+ */
+void receiveFiles(const char* txt)
+{
+  if (! canTransfer()) return;
+#if HAS_YMODEM
+  session->print("Start the YMODEM upload, CAN CAN aborts\r\n");
+  session->flush();  // no text between the blocks
+  if (! ymodem().receive(session->transport()))
+  {
+    session->print("Cannot mount LittleFS ");
+    reportInvalid();
+  }
+#endif
+}
+
+
+#if HAS_YMODEM
+void onSendPath(const char* line)
+{
+  char path[YMODEM_NAME + 1] = "/";
+
+  strncat(path, line + (*line == '/'), YMODEM_NAME - 1);
+  if (! ymodem().send(session->transport(), path))
+  {
+    emit(*session, "Cannot open ", path, ' ');
+    reportInvalid();
+    return;
+  }
+  session->print("Start the YMODEM download\r\n");
+  session->flush();
+}
+#endif
+
+/**
+ * List the files in LittleFS and send the one entered to the host
+ */
+void sendFile(const char* txt)
+{
+  if (! canTransfer()) return;
+#if HAS_YMODEM
+  File root = LittleFS.open("/", "r");
+  if (root && root.isDirectory())
+  {
+    for (File f = root.openNextFile(); f; f = root.openNextFile())
+    {
+      emit(*session, width(f.size(), 8), ' ', f.name(), "\r\n");
+      f.close();
+    }
+    root.close();
+  }
+  session->ask("File to send: ", onSendPath);
+#endif
+}
+
+
+#if HAS_YMODEM
+/**
+ * Report the outcome and the rate of the transfer just ended
+ */
+void endTransfer()
+{
+  uint32_t rate = ymodem().elapsed ? (uint64_t)ymodem().bytes * 1000 / ymodem().elapsed : 0;
+
+  session->print(ymodem().ok ? "\r\nTransfer done, " : "\r\nTransfer failed, ");
+  emit(*session, ymodem().files, " files, ", ymodem().bytes, " bytes in ", ymodem().elapsed, " ms, ",
+       rate, " bytes/s at ", baudRate, " baud ");
+  report((int32_t)rate);
+}
+#endif
+
+
+void onDumpRange(const char* line)
+{
+  HexDump::Source source = HexDump::Ram;
+  uint32_t        start, length;
+
+  if (*line == 'f')
+  {
+    source = HexDump::Flash;
+    line++;
+  }
+  if (! parseRange(line, start, length))
+  {
+    emit(*session, "Not a range: ", line);
+    reportInvalid();
+    return;
+  }
+  if (! hexDump.start(session, source, start, length))
+  {
+    session->print("Range not readable ");
+    reportInvalid();
+    return;
+  }
+  session->print("\r\n");
+  dumpSession = session;
+  report((int32_t)length);
+}
+
+/**
+ * Dump a range of RAM or flash in hex, [x] again stops the dump
+ */
+void dumpMemory(const char* txt)
+{
+  if (dumpSession == session)
+  {
+    hexDump.stop();
+    dumpSession = nullptr;
+    session->print("Dump stopped ");
+    return;
+  }
+  if (dumpSession)
+  {
+    session->print("Another session is dumping ");
+    reportInvalid();
+    return;
+  }
+  session->ask("Start and length, f before start for flash: ", onDumpRange);
+}
+
+
+/**
+ * Run the action bound to the oldest queued edge
+ */
+void serveEdge()
+{
+  EdgeEvent event;
+
+  if (! edgePop(event)) return;
+  session = &sessions[0];
+  edgeLatency(timeUs() - event.micros);
+  emit(*session, "\r\nEdge on pin ", edgeBindings[event.binding].pin, ": ");
+  int i = menu.find(edgeBindings[event.binding].key);
+  if (i >= 0) dispatch(i);
 }
 
 
@@ -183,9 +968,183 @@ void toggleHeartbeat(const char* txt)
 {
   heartbeatEnabled = !heartbeatEnabled;
   if (heartbeatEnabled)
-    Serial.print("Heartbeat on ");
+    session->print("Heartbeat on ");
   else
-    Serial.print("Heartbeat off ");
+    session->print("Heartbeat off ");
+  report(heartbeatEnabled);
+}
+
+
+/**
+ * Flash the led with the given pattern
+ */
+void setBeat(const Beat& pattern)
+{
+  beat = pattern;
+  emit(*session, "Heartbeat every ", beat.period, " ms for ", beat.pulseWidth, " ms ");
+  report((int32_t)beat.period);
+}
+
+
+void setSetpoint(float value)
+{
+  setpoint = value;
+  emit(*session, "Setpoint ", fixed(setpoint, 1), " C ");
+  report((double)setpoint);
+}
+
+
+void readPin(uint8_t pin)
+{
+  bool high = gpioRead(pin);
+  emit(*session, "Pin ", pin, high ? " is high " : " is low ");
+  report(high);
+}
+
+
+/**
+ * List the peak stack usage of each action measured so far
+ */
+void showStackUsage(const char* txt)
+{
+  emit(*session, "Peak stack usage (probe depth ", STACK_PROBE_DEPTH, " bytes)\r\n");
+  for (int i = 0; i < nbrMenuItems; i++)
+  {
+    emit(*session, menu[i].key, ' ', stackPeak[i] >= STACK_PROBE_DEPTH ? ">=" : "  ", 
+         width(stackPeak[i], 5), "  ", menu[i].txt, "\r\n");
+  }
+}
+
+
+/**
+ * Time the primitives of the CLI in CPU cycles. Prints a table and a 
+ * single line with all figures for collection by a script.
+ */
+void runBenchmark(const char* txt)
+{
+#if defined(ESP32)
+  const char* board = "esp32";
+#elif defined(ESP8266)
+  const char* board = "esp8266";
+#else
+  const char* board = "avr";
+#endif
+  constexpr uint16_t RUNS = 100;
+  constexpr uint8_t  LINES = 8;  // written to measure the transport, 64 bytes each
+  constexpr uint8_t  TOKENS = 10; // of the expression evaluated: ( 0x40 << 2 ) + 3 * - 7
+  struct { const char* name; uint32_t cycles; } rows[12];
+  uint8_t   n = 0;
+  NullPrint sink;
+  int32_t   i32;
+  double    f64;
+  tm        t;
+
+  cyclesBegin();
+  session->redirect(&sink);  // the actions print into the null sink
+  rows[n++] = { "dispatch",     measureCycles(RUNS, [] { menu.run(menu.find('h')); }) };
+  rows[n++] = { "json_request", measureCycles(RUNS, [&] 
+  {
+    char        request[] = "{\"cmd\":\"h\"}";
+    char        cmd;
+    const char* arg;
+
+    parseJsonRequest(request, cmd, arg);
+    menu.run(menu.find(cmd));
+    emit(sink, "{\"cmd\":\"", cmd, "\",\"text\":\"\",\"ok\":true");
+    printJsonValue(sink, result);
+    sink.print("}\r\n");
+  }) };
+  uint32_t json = rows[n - 1].cycles;
+  session->redirect(nullptr);
+
+  // the last key is found after all others, by memchr() over the packed keys 
+  // of the menu and by the scan of a MenuItem table, one item stride per key
+  volatile char key = menu[nbrMenuItems - 1].key;
+  volatile int  found;
+  rows[n++] = { "key_find",     measureCycles(RUNS, [&] { found = menu.find(key); }) };
+  rows[n++] = { "key_scan",     measureCycles(RUNS, [&] 
+  {
+    char k = key;
+    int  i = 0;
+    while (i < nbrMenuItems && menu[i].key != k) i++;
+    found = i;
+  }) };
+  rows[n++] = { "int_parse",    measureCycles(RUNS, [&] { parseInteger("-1234567", i32); }) };
+  rows[n++] = { "int_evaluate", measureCycles(RUNS, [&] { evaluate("(0x40 << 2) + 3 * -7", i32); }) };
+  uint32_t token = rows[n - 1].cycles / TOKENS;
+  rows[n++] = { "int_format",   measureCycles(RUNS, [&] { emit(sink, (int32_t)-1234567); }) };
+  rows[n++] = { "float_parse",  measureCycles(RUNS, [&] { parseFloat("3.14159265", f64); }) };
+  rows[n++] = { "float_format", measureCycles(RUNS, [&] { emit(sink, fixed(3.14159265, 6)); }) };
+  rows[n++] = { "date_parse",   measureCycles(RUNS, [&] { parseDateTime("2024 10 24 12 34 56", t); }) };
+  rows[n++] = { "menu_render",  measureCycles(10, [&] 
+  {
+    for (uint16_t i = 0; i < menuCount(); i++) 
+    {
+      menuLine(sink, i);
+      sink.print("\r\n");
+    }
+  }) };
+
+  session->flush();
+  Stream* io = session->transport();
+  rows[n++] = { "write_64x8",   measureCycles(1, [&] 
+  {
+    for (uint8_t i = 0; i < LINES; i++) emit(*io, repeat('-', 62), "\r\n");
+    io->flush();
+  }) };
+  cyclesEnd();
+
+  uint16_t mhz  = cyclesPerMicro();
+  uint32_t rate = (uint64_t)LINES * 64 * mhz * 1000000 / rows[n - 1].cycles;
+  uint32_t requests = (uint64_t)mhz * 1000000 / json;
+
+  emit(*session, "\r\n", board, " at ", mhz, " MHz      cycles        us\r\n");
+  for (uint8_t i = 0; i < n; i++)
+  {
+    emit(*session, rows[i].name, repeat(' ', 16 - strlen(rows[i].name)), width(rows[i].cycles, 12), 
+         width(fixed((double)rows[i].cycles / mhz, 1), 10), "\r\n");
+  }
+  emit(*session, "write rate ", rate, " bytes/s, json rate ", requests, " requests/s, evaluate ", token, 
+       " cycles/token\r\n");
+  emit(*session, "bench board=", board, " mhz=", mhz);
+  for (uint8_t i = 0; i < n; i++) emit(*session, ' ', rows[i].name, '=', rows[i].cycles);
+  emit(*session, " write_bps=", rate, " json_rps=", requests, " eval_cpt=", token, "\r\n");
+}
+
+
+void showSample(const MemSample& s)
+{
+  emit(*session, width(s.ms, 8), "  ", s.key, "  ", width(s.freeHeap, 7), ' ', width(s.largestBlock, 7), 
+       "  ", width(s.minFreeHeap, 7), ' ', width(s.stackFree, 7), "  ", width(s.fragmentation, 3), "%\r\n");
+}
+
+
+/**
+ * Report the current heap and stack figures, marked *, followed by the 
+ * samples traced after the recent actions
+ */
+void showMemory(const char* txt)
+{
+  MemSample s;
+
+  memSample(s, '*');
+  session->print("      ms key    free largest  minfree   stack frag\r\n");
+  showSample(s);
+  for (uint8_t age = 0; memTraceAt(age, s); age++) showSample(s);
+}
+
+
+/**
+ * List the active sessions, the own one marked with *
+ */
+void showSessions(const char* txt)
+{
+  for (uint8_t i = 0; i < MAX_SESSIONS; i++)
+  {
+    if (! sessions[i].active()) continue;
+    emit(*session, &sessions[i] == session ? '*' : ' ', i, ' ', i == 0 ? "serial" : "telnet", 
+         sessions[i].asking() ? ", entering a value\r\n" : "\r\n");
+  }
 }
 
 
@@ -195,62 +1154,413 @@ void toggleHeartbeat(const char* txt)
 void showMenu(const char* txt)
 {
   // title is packed into a raw string
-  Serial.print(
+  session->print(
   R"TITLE(
 ---------------
  CLI Menu Demo 
 ---------------
 )TITLE");
 
-  for (int i = 0; i < nbrMenuItems; i++)
+  if constexpr (FEATURE_LISTS)
+  {
+    session->pager.open(menuCount, menuLine);
+    showPage();
+  }
+  else
   {
-    Serial.println(menu[i].txt);
+    // without the page keys the whole menu is shown at once
+    for (uint16_t i = 0; i < menuCount(); i++)
+    {
+      menuLine(*session, i);
+      session->print("\r\n");
+    }
+    session->print("\nPress a key: ");
   }
-  Serial.print("\nPress a key: ");
+}
+
+
+/**
+ * Lines of the menu as shown by the pager
+ */
+uint16_t menuCount()
+{
+  return menu.size();
+}
+
+void menuLine(Print& out, uint16_t i)
+{
+  menu.print(out, i);
+}
+
+
+/**
+ * A long list generated line by line as the pager asks for it
+ */
+constexpr uint16_t NBR_STATIONS = 5000;
+
+uint16_t stationCount()
+{
+  return NBR_STATIONS;
+}
+
+void stationLine(Print& out, uint16_t i)
+{
+  emit(out, "Station ", width(i + 1, 4, '0'), "  FM ", width(fixed(87.5 + (i % 206) * 0.1, 1), 5), " MHz");
+}
+
+
+void browseStations(const char* txt)
+{
+  session->pager.open(stationCount, stationLine);
+  showPage();
+}
+
+
+/**
+ * Show the current page of the list the session is browsing
+ */
+void showPage()
+{
+  if (session == tuiSession) return;  // the menu pane shows it
+  session->pager.show(*session);
+  session->print("\nPress a key: ");
+}
+
+
+void nextPage(const char* txt)
+{
+  if (session->pager.next()) showPage();
+}
+
+
+void previousPage(const char* txt)
+{
+  if (session->pager.previous()) showPage();
+}
+
+
+void onPage(const char* line)
+{
+  int32_t page;
+
+  if (! parseInteger(line, page) || page < 1 || ! session->pager.jump(page - 1))
+  {
+    emit(*session, "No page ", line, " of ", session->pager.pages());
+    reportInvalid();
+    return;
+  }
+  showPage();
+}
+
+void goToPage(const char* txt)
+{
+  session->ask("Page: ", onPage);
+}
+
+
+/**
+ * Redraw the first page of matches while the filter text is typed
+ */
+void onFilterEdit(const char* line)
+{
+  if (! session->pager.filter(line)) return;
+  session->print("\x1b[H\x1b[2J");  // clear the screen
+  session->pager.show(*session);
+  session->print("\r\nFilter: ");
+  session->print(line);
+}
+
+void onFilter(const char* line)
+{
+  if (! session->pager.filter(line))
+  {
+    session->print("The list is too long to be filtered ");
+    reportInvalid();
+    return;
+  }
+  report((int32_t)session->pager.size());
+  showPage();
+}
+
+/**
+ * Filter the list being browsed, the menu if there is none
+ */
+void filterList(const char* txt)
+{
+  if (! session->pager.active()) session->pager.open(menuCount, menuLine);
+  session->pager.clearFilter();
+  session->ask("Filter: ", onFilter, onFilterEdit);
+}
+
+
+/**
+ * Execute the action of menuitem i and record its stack usage
+ */
+void dispatch(int i)
+{
+  if constexpr (FEATURE_MACROS)
+  {
+    if (session == macroSession && menu[i].action != toggleRecording && menu[i].action != playMacro)
+    {
+      macro.key(menu[i].key);
+    }
+  }
+  if constexpr (FEATURE_DIAGNOSTICS)
+  {
+    stackPaint();
+    menu.run(i);
+    uint16_t used = stackMeasure();
+    if (used > stackPeak[i]) stackPeak[i] = used;
+
+    MemSample mem;
+    memSample(mem, menu[i].key);
+    memTrace(mem);
+  }
+  else
+  {
+    menu.run(i);
+  }
+  lastKey = menu[i].key;
 }
 
 
 /**
  * Execute the action assigned to the key
  */
-void doMenu()
+void doMenu(char key)
 {
-  char key = Serial.read();
-  CLEAR_LINE;
+  int i = menu.find(key);
 
-  for (int i = 0; i < nbrMenuItems; i++)
+  if (session == tuiSession) session->print("\r\n"); // keep the log of the full screen
+  else CLEAR_LINE;
+  if (i >= 0) dispatch(i);
+}
+
+
+/**
+ * Answer a JSON request. The text printed by the action becomes the "text"
+ * of the reply, a value it reports becomes "value". An action asking for 
+ * input gets "arg" as the entered line.
+ */
+void onJsonRequest(const char* line)
+{
+  char        buf[LINE_SIZE];
+  char        cmd;
+  const char* arg;
+  const char* error = nullptr;
+  int         i;
+
+  strcpy(buf, line);
+  if (! parseJsonRequest(buf, cmd, arg))
+  {
+    session->print("{\"ok\":false,\"error\":\"bad request\"}\r\n");
+    session->ask("", onJsonRequest);
+    return;
+  }
+
+  result.type = JsonResult::None;
+  session->print("{\"cmd\":\"");
+  session->setEscape(true);
+  session->print(cmd);
+  session->setEscape(false);
+  session->print("\",\"text\":\"");
+  session->setEscape(true);
+  if ((i = menu.find(cmd)) < 0)
+  {
+    error = "unknown cmd";
+  }
+  else
   {
-    if (key == menu[i].key)
+    dispatch(i);
+    if (session->asking() && arg) session->answer(arg);
+    if (session->asking())
     {
-      menu[i].action(menu[i].arg);
-      break;
+      session->cancel();
+      error = "arg required";
     }
-  } 
+    if (result.type == JsonResult::Failed) error = "invalid arg";
+  }
+  session->setEscape(false);
+  session->print(error ? "\",\"ok\":false,\"error\":\"" : "\",\"ok\":true");
+  if (error) emit(*session, error, '"');
+  printJsonValue(*session, result);
+  session->print("}\r\n");
+
+  if (session->jsonMode()) session->ask("", onJsonRequest);
+}
+
+
+/**
+ * Switch the own session between text and JSON mode
+ */
+void toggleJson(const char* txt)
+{
+  session->setJson(! session->jsonMode());
+  report(session->jsonMode());
+  if (session->jsonMode()) session->ask("", onJsonRequest);
 }
 
 
 /**
  * Flash the led on pin with period and pulse width
  */
-void heartbeat(uint8_t pin, uint32_t period, uint32_t pulseWidth)
+void heartbeat(OutputPin& led, uint32_t period, uint32_t pulseWidth)
 {
-  digitalWrite(pin, millis() % period < pulseWidth ? HIGH : LOW);
+  led.write(timeMs() % period < pulseWidth);
 }
 
 
 void setup() 
 {
-  Serial.begin(115200);
-  pinMode(LED_BUILTIN, OUTPUT);
+  sessions[0].attach(&uartBegin(baudRate));
+#if defined(UART_CTS_PIN) && defined(UART_RTS_PIN)
+  rtsCts = uartHardwareFlow(UART_CTS_PIN, UART_RTS_PIN);
+#endif
+  led.begin(LED_BUILTIN);
+  if constexpr (FEATURE_MACROS) macro.load();
+  if constexpr (FEATURE_EDGES)
+  {
+    for (uint8_t i = 0; i < nbrEdgeBindings; i++)
+    {
+      edgeAttach(i, edgeBindings[i].pin, edgeBindings[i].mode);
+    }
+  }
+#if HAS_TELNET && defined(WIFI_SSID)
+  if constexpr (FEATURE_TELNET)
+  {
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(WIFI_SSID, WIFI_PASS); // connects in the background
+    telnetServer.begin();
+    telnetServer.setNoDelay(true);
+  }
+#endif
   showMenu("");
 }
 
 
+#if HAS_TELNET
+/**
+ * Give a new telnet connection a free session, refuse it if there is none
+ */
+void acceptTelnet()
+{
+  if (! telnetServer.hasClient()) return;
+
+  for (uint8_t i = 1; i < MAX_SESSIONS; i++)
+  {
+    if (sessions[i].active()) continue;
+    telnet[i - 1].accept(telnetServer);
+    sessions[i].attach(&telnet[i - 1]);
+    session = &sessions[i];
+    showMenu("");
+    return;
+  }
+  // all sessions taken, turn the client away
+#if defined(ESP32)
+  telnetServer.available().stop();
+#else
+  telnetServer.accept().stop();
+#endif
+}
+#endif
+
+
 void loop() 
 {
-  // handle the menu
-  if(Serial.available()) doMenu();
+  static uint32_t loops, loopStart;
+
+  if (++loops, timeMs() - loopStart >= 1000)
+  {
+    loopRate  = loops;
+    loops     = 0;
+    loopStart = timeMs();
+  }
+
+#if HAS_TELNET
+  if constexpr (FEATURE_TELNET)
+  {
+    acceptTelnet();
+    for (uint8_t i = 1; i < MAX_SESSIONS; i++)
+    {
+      if (! sessions[i].active() || telnet[i - 1].connected()) continue;
+      if (tuiSession == &sessions[i])
+      {
+        sessions[i].redirect(nullptr);
+        tuiSession = nullptr;
+      }
+      if (dumpSession == &sessions[i])
+      {
+        hexDump.stop();
+        dumpSession = nullptr;
+      }
+      if constexpr (FEATURE_TELEMETRY)
+      {
+        if (telemetrySession == &sessions[i])
+        {
+          telemetry.stop();
+          telemetrySession = nullptr;
+        }
+      }
+      if constexpr (FEATURE_MACROS)
+      {
+        if (macroSession == &sessions[i])   // the recording ends with its session, as with [r]
+        {
+          macro.stop();
+          macroSession = nullptr;
+        }
+      }
+      sessions[i].setTap(nullptr);
+      sessions[i].detach();
+    }
+  }
+#endif
+
+  // fall back if a new baud rate was not confirmed in time
+  if (baudDeadline && (int32_t)(timeMs() - baudDeadline) >= 0)
+  {
+    session = &sessions[0];
+    session->cancel();
+    revertBaudRate();
+  }
+
+  // serve the sessions in turn, each handles at most one key or line per pass
+  for (Session& s : sessions)
+  {
+    if (! s.active()) continue;
+    session = &s;
+#if HAS_YMODEM
+    if constexpr (FEATURE_YMODEM)
+    {
+      if (&s == &sessions[0] && ymodem().active())
+      {
+        ymodem().poll();   // the transfer owns the transport until it ends
+        if (! ymodem().active()) endTransfer();
+        continue;
+      }
+    }
+#endif
+    int key = s.step();
+    if (key >= 0) doMenu(key);
+    if constexpr (FEATURE_DIAGNOSTICS)
+    {
+      if (dumpSession == &s)
+      {
+        hexDump.poll();
+        if (! hexDump.active()) dumpSession = nullptr;
+      }
+    }
+    if constexpr (FEATURE_STATUS)
+    {
+      if (s.status.due(timeMs())) updateStatusLine();
+    }
+    if constexpr (FEATURE_FULL_SCREEN)
+    {
+      if (tuiSession == &s && timeMs() - tuiDrawn >= TUI_PERIOD) drawFullScreen();
+    }
+    s.pump();
+  }
   
-  // illustrates the blocking behavior when entering numbers and text
-  if (heartbeatEnabled) heartbeat(LED_BUILTIN, 1000, 20);
-}
\ No newline at end of file
+  if constexpr (FEATURE_EDGES) serveEdge();
+  if constexpr (FEATURE_TELEMETRY) telemetry.poll();
+  if (heartbeatEnabled) heartbeat(led, beat.period, beat.pulseWidth);
+}
@@ -0,0 +1,49 @@
+#pragma once
+/**
+ * Fuzz targets for the parsers that take input from the peer.
+ *
+ * Every target is a libFuzzer entry point, built alone with clang:
+ *
+ *   clang++ -std=gnu++17 -g -fsanitize=fuzzer,address,undefined -Iinclude -Itest/host \
+ *     test/fuzz/fuzz_expr.cpp src/Expr.cpp -o fuzz_expr
+ *   ./fuzz_expr test/fuzz/corpus/expr
+ *
+ * For AFL or a plain sanitizer build add test/fuzz/replay.cpp, which feeds 
+ * the files named on the command line, or stdin, to the target:
+ *
+ *   afl-clang-fast++ -std=gnu++17 -fsanitize=address,undefined -Iinclude -Itest/host \
+ *     test/fuzz/fuzz_expr.cpp test/fuzz/replay.cpp src/Expr.cpp -o fuzz_expr
+ *   afl-fuzz -i test/fuzz/corpus/expr -o findings -- ./fuzz_expr
+ *
+ * fuzz_session needs the menu library and the session with its pager and
+ * status line as well:
+ *
+ *   clang++ -std=gnu++17 -g -fsanitize=fuzzer,address,undefined -Iinclude -Ilib/Menu \
+ *     -Itest/host test/fuzz/fuzz_session.cpp src/Session.cpp src/Pager.cpp \
+ *     src/StatusLine.cpp -o fuzz_session
+ *
+ * With FUZZ_CORPUS defined each target becomes a function fuzz_<name>() 
+ * instead, test_corpus runs them all over their seed corpora in the 
+ * native env.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(FUZZ_CORPUS)
+#define FUZZ_TARGET(name) int fuzz_##name(const uint8_t* data, size_t size)
+#else
+#define FUZZ_TARGET(name) extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+#endif
+
+constexpr size_t FUZZ_LINE = 256;  // longer input is cut, a line never gets longer
+
+/**
+ * Copy the input into line and terminate it like a line entered
+ */
+inline void fuzzLine(char (&line)[FUZZ_LINE], const uint8_t* data, size_t size)
+{
+  if (size > FUZZ_LINE - 1) size = FUZZ_LINE - 1;
+  memcpy(line, data, size);
+  line[size] = '\0';
+}
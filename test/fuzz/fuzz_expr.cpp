@@ -0,0 +1,43 @@
+#include <math.h>
+#include <stdlib.h>
+#include "Fuzz.h"
+#include "Expr.h"
+
+/**
+ * Names as the menu has them, f is beyond the range of an integer
+ */
+static bool lookup(const char* name, uint8_t len, int32_t& value)
+{
+  if (len != 1) return false;
+  switch (*name)
+  {
+    case 'i': value = 7;         return true;
+    case 'm': value = INT32_MIN; return true;
+    default:                     return false;
+  }
+}
+
+static bool lookup(const char* name, uint8_t len, double& value)
+{
+  if (len != 1) return false;
+  switch (*name)
+  {
+    case 'i': value = 7;      return true;
+    case 'n': value = -3.5;   return true;
+    case 'f': value = 1e20;   return true;
+    default:                  return false;
+  }
+}
+
+
+FUZZ_TARGET(expr)
+{
+  char    line[FUZZ_LINE];
+  int32_t i;
+  double  f;
+
+  fuzzLine(line, data, size);
+  evaluate(line, i, lookup);
+  if (evaluate(line, f, lookup) && ! isfinite(f)) abort();
+  return 0;
+}
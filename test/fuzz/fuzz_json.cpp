@@ -0,0 +1,30 @@
+#include <stdlib.h>
+#include "Fuzz.h"
+#include "JsonLine.h"
+
+FUZZ_TARGET(json)
+{
+  char        line[FUZZ_LINE];
+  char        cmd;
+  const char* arg;
+
+  fuzzLine(line, data, size);
+  {
+    JsonTokenizer json(line);
+    JsonToken     token;
+
+    // every call consumes input, so a line ends after as many tokens as it has characters
+    for (size_t n = 0; (token = json.next()) != JsonToken::End && token != JsonToken::Error; n++)
+    {
+      if (n > FUZZ_LINE) abort();
+    }
+  }
+
+  fuzzLine(line, data, size);
+  if (parseJsonRequest(line, cmd, arg))
+  {
+    if (cmd == '\0') abort();
+    if (arg && (arg < line || arg >= line + FUZZ_LINE)) abort();
+  }
+  return 0;
+}
@@ -0,0 +1,30 @@
+#include <math.h>
+#include <stdlib.h>
+#include "Fuzz.h"
+#include "CliParse.h"
+
+FUZZ_TARGET(parse)
+{
+  char     line[FUZZ_LINE];
+  int32_t  i;
+  double   f;
+  tm       t;
+  uint32_t start, length;
+
+  fuzzLine(line, data, size);
+  parseInteger(line, i);
+  if (parseFloat(line, f) && ! isfinite(f)) abort();
+  if (parseDateTime(line, t))
+  {
+    static const uint8_t daysInMonth[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int  y    = t.tm_year + 1900;
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+
+    if (y < DATE_MIN_YEAR || y > DATE_MAX_YEAR) abort();
+    if (t.tm_mon < 0 || t.tm_mon > 11 || t.tm_mday < 1 || t.tm_mday > daysInMonth[t.tm_mon]) abort();
+    if (t.tm_mon == 1 && t.tm_mday == 29 && ! leap) abort();
+    if (t.tm_hour > 23 || t.tm_min > 59 || t.tm_sec > 59) abort();
+  }
+  if (parseRange(line, start, length) && (length == 0 || length - 1 > UINT32_MAX - start)) abort();
+  return 0;
+}
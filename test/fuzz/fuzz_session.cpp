@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include "Fuzz.h"
+#include "Loopback.h"
+#include "Menu.h"
+#include "Session.h"
+
+/**
+ * The input of a session, bytes as a peer would type them, with a menu 
+ * behind it that asks for lines, switches the modes and pages a list.
+ * A write into the full queue while the peer holds XOFF waits for 
+ * XOFF_TIMEOUT as on the board, unless more input follows.
+ */
+namespace fuzzSession
+{
+  Loopback io(64, 16);
+  Session  session;
+
+  void checkLine(const char* line)
+  {
+    if (strlen(line) >= LINE_SIZE) abort();
+  }
+
+  void onFilter(const char* line)
+  {
+    checkLine(line);
+    session.pager.filter(line);
+    session.pager.show(session);
+  }
+
+  uint16_t lineCount() { return 40; }
+  void     printLine(Print& out, uint16_t i) { out.print("line "); out.println(i); }
+
+  void askValue(const char*)    { session.ask("value? ", checkLine); }
+  void askEdited(const char*)   { session.ask("edit? ", checkLine, checkLine); }
+  void askFilter(const char*)   { session.ask("filter? ", onFilter); }
+  void toggleJson(const char*)  { session.setJson(! session.jsonMode()); }
+  void toggleFlow(const char*)  { session.setFlowControl(! session.flowControl()); }
+  void setEscape(const char*)   { session.setEscape(true); }
+  void openList(const char*)    { session.pager.open(lineCount, printLine); session.pager.show(session); }
+  void nextPage(const char*)    { session.pager.next(); session.pager.show(session); }
+  void previousPage(const char*){ session.pager.previous(); session.pager.show(session); }
+  void longOutput(const char*)  { for (uint16_t i = 0; i < OUT_SIZE / 4; i++) session.print("out "); }
+
+  constexpr MenuItem items[] =
+  {
+    { 'v', "[v] Value",       "", askValue },
+    { 'e', "[e] Edited",      "", askEdited },
+    { '/', "[/] Filter",      "", askFilter },
+    { 'j', "[j] JSON",        "", toggleJson },
+    { 'f', "[f] XON/XOFF",    "", toggleFlow },
+    { 'x', "[x] Escape",      "", setEscape },
+    { 'l', "[l] List",        "", openList },
+    { 'n', "[n] Next page",   "", nextPage },
+    { 'b', "[b] Back",        "", previousPage },
+    { 'o', "[o] Long output", "", longOutput },
+  };
+  constexpr Menu<10> menu(items);
+}
+
+FUZZ_TARGET(session)
+{
+  using namespace fuzzSession;
+
+  io = Loopback(64, 16);
+  io.send(data, size);
+  session.attach(&io);
+
+  // every step takes at least one byte, so the input ends after as many steps as it has bytes
+  for (size_t n = 0; io.available(); n++)
+  {
+    if (n > size) abort();
+    int key = session.step();
+    if (key >= 0) menu.dispatch(key);
+    session.pump();
+    io.tick();
+  }
+  session.setFlowControl(false);
+  session.flush();
+  session.detach();
+  return 0;
+}
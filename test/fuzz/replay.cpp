@@ -0,0 +1,36 @@
+/**
+ * Runs a fuzz target on the files given, or on stdin without arguments,
+ * for AFL and for builds without libFuzzer. See Fuzz.h.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static void run(FILE* in)
+{
+  static uint8_t data[4096];
+  size_t         size = fread(data, 1, sizeof(data), in);
+
+  LLVMFuzzerTestOneInput(data, size);
+}
+
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) run(stdin);
+  for (int i = 1; i < argc; i++)
+  {
+    FILE* in = fopen(argv[i], "rb");
+
+    if (in == nullptr)
+    {
+      perror(argv[i]);
+      return 1;
+    }
+    run(in);
+    fclose(in);
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+/**
+ * Just enough of the Arduino core to build the portable modules and the 
+ * unit tests in the native env. Time is taken from the steady clock of 
+ * the host. attachInterrupt() keeps the handler in hostInterrupts, where
+ * a test calls it to raise the interrupt.
+ */
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "Print.h"
+
+#define PROGMEM
+#define IRAM_ATTR
+
+inline uint32_t micros()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline uint32_t millis() { return micros() / 1000; }
+inline void     delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void     yield() {}
+
+enum : uint8_t { INPUT, OUTPUT, INPUT_PULLUP };
+enum : int     { CHANGE = 1, FALLING = 2, RISING = 3 };
+
+constexpr uint8_t HOST_INTERRUPTS = 40;
+inline void (*hostInterrupts[HOST_INTERRUPTS])();
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int  digitalPinToInterrupt(uint8_t pin) { return pin < HOST_INTERRUPTS ? pin : -1; }
+inline void attachInterrupt(int irq, void (*handler)(), int) { if (irq >= 0) hostInterrupts[irq] = handler; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
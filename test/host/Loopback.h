@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * A transport looped back to the test, in place of Serial or a telnet client.
+ *
+ * The test sends input with send() and finds the output in received. The 
+ * transport drains rate bytes per tick() from a send buffer of the given
+ * size, like a UART draining its FIFO or a socket its send window. A write
+ * larger than the free buffer blocks like the real one would: the ticks 
+ * it has to wait are counted in blocked.
+ */
+#include <string>
+#include <Arduino.h>
+
+class Loopback : public Stream
+{
+  public:
+    Loopback(size_t buffer = 4096, size_t rate = 4096) : buffer(buffer), rate(rate) {}
+
+    void send(const char* text) { input += text; }
+    void send(const uint8_t* data, size_t size) { input.append((const char*)data, size); }
+    void tick()
+    {
+      pending -= pending < rate ? pending : rate;
+      ticks++;
+    }
+
+    int available() override { return input.size() - pos; }
+    int read() override { return pos < input.size() ? (uint8_t)input[pos++] : -1; }
+    int peek() override { return pos < input.size() ? (uint8_t)input[pos] : -1; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override
+    {
+      for (size_t i = 0; i < size; i++)
+      {
+        while (pending == buffer)
+        {
+          tick();
+          blocked++;
+        }
+        received += (char)buf[i];
+        pending++;
+      }
+      return size;
+    }
+    int availableForWrite() override { return buffer - pending; }
+    using Print::write;
+
+    std::string received;     // everything written so far
+    uint32_t    ticks = 0;    // ticks passed, including those blocked
+    uint32_t    blocked = 0;  // ticks a write had to wait for room
+
+  private:
+    size_t      buffer;
+    size_t      rate;         // bytes sent per tick
+    size_t      pending = 0;  // bytes in the send buffer
+    std::string input;
+    size_t      pos = 0;
+};
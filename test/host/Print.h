@@ -0,0 +1,61 @@
+#pragma once
+/**
+ * Print of the Arduino core for the native env, as far as the modules 
+ * built on the host use it.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size)
+    {
+      size_t n = 0;
+
+      while (n < size && write(buf[n])) n++;
+      return n;
+    }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buf, size_t size) { return write((const uint8_t*)buf, size); }
+    virtual int  availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char* str)                 { return write(str); }
+    size_t print(char c)                          { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC)           { return print((long)v, base); }
+    size_t print(unsigned v, int base = DEC)      { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC)          { return base == DEC ? format("%ld", v) : print((unsigned long)v, base); }
+    size_t print(unsigned long v, int base = DEC) { return format(base == HEX ? "%lX" : "%lu", v); }
+    size_t print(double v, int digits = 2)
+    {
+      // like the cores, which print the integer part as a uint32_t
+      if (isnan(v)) return write("nan");
+      if (isinf(v)) return write("inf");
+      if (v > 4294967040.0 || v < -4294967040.0) return write("ovf");
+      return format("%.*f", digits, v);
+    }
+    size_t println()                              { return write("\r\n"); }
+
+    template<typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+
+  private:
+    template<typename... Args>
+    size_t format(const char* fmt, Args... args)
+    {
+      char buf[64];
+
+      snprintf(buf, sizeof(buf), fmt, args...);
+      return write(buf);
+    }
+};
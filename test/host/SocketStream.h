@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * One end of a real socket as transport, in place of a telnet client.
+ *
+ * The socket is non-blocking. availableForWrite() answers like the one of
+ * TelnetStream on the ESP32: a segment if select() finds the socket 
+ * writable, else nothing. A write the socket takes only in part is 
+ * counted in shortWrites, the session sends the rest on its next pass.
+ */
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <Arduino.h>
+
+class SocketStream : public Stream
+{
+  public:
+    static constexpr int SEGMENT = 1436;  // TCP_MSS of lwIP
+
+    explicit SocketStream(int fd) : fd(fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+    int available() override
+    {
+      int n = 0;
+      ioctl(fd, FIONREAD, &n);
+      return n + (next >= 0);
+    }
+    int read() override
+    {
+      int c = peek();
+      next = -1;
+      return c;
+    }
+    int peek() override
+    {
+      uint8_t c;
+
+      if (next < 0 && recv(fd, &c, 1, 0) == 1) next = c;
+      return next;
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override
+    {
+      ssize_t n = send(fd, buf, size, MSG_NOSIGNAL);
+      if (n < 0) n = 0;
+      if ((size_t)n < size) shortWrites++;
+      return n;
+    }
+    int availableForWrite() override
+    {
+      fd_set  writable;
+      timeval none = { 0, 0 };
+
+      FD_ZERO(&writable);
+      FD_SET(fd, &writable);
+      return select(fd + 1, nullptr, &writable, nullptr, &none) > 0 ? SEGMENT : 0;
+    }
+    using Print::write;
+
+    uint32_t shortWrites = 0;  // writes the socket took only in part
+
+  private:
+    int fd;
+    int next = -1;  // byte read ahead, -1 if none
+};
@@ -0,0 +1,69 @@
+/**
+ * The board layer on the host, as the native env builds it
+ */
+#include <unity.h>
+#include "Board.h"
+#include "CliParse.h"
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_output_pin()
+{
+  OutputPin pin;
+
+  pin.begin(5);
+  pin.write(true);
+  TEST_ASSERT_TRUE(gpioRead(5));
+  TEST_ASSERT_FALSE(gpioRead(6));
+  pin.write(false);
+  TEST_ASSERT_FALSE(gpioRead(5));
+}
+
+
+void test_clock()
+{
+  tm set, now;
+
+  TEST_ASSERT_FALSE(rtcGet(now));
+  TEST_ASSERT_TRUE(parseDateTime("2024 02 29 23 59 58", set));
+  rtcSet(set);
+  TEST_ASSERT_TRUE(rtcGet(now));
+  TEST_ASSERT_EQUAL(124, now.tm_year);
+  TEST_ASSERT_EQUAL(1, now.tm_mon);
+  TEST_ASSERT_EQUAL(29, now.tm_mday);
+  TEST_ASSERT_EQUAL(23, now.tm_hour);
+  TEST_ASSERT_EQUAL(58, now.tm_sec);
+}
+
+
+/**
+ * Every date the parser takes is one the clock reads back as set
+ */
+void test_clock_bounds()
+{
+  tm set, now;
+
+  TEST_ASSERT_TRUE(parseDateTime("2020 01 01 00 00 00", set));
+  rtcSet(set);
+  TEST_ASSERT_TRUE(rtcGet(now));
+  TEST_ASSERT_EQUAL(120, now.tm_year);
+
+  TEST_ASSERT_TRUE(parseDateTime("2037 12 31 23 59 59", set));
+  rtcSet(set);
+  TEST_ASSERT_TRUE(rtcGet(now));
+  TEST_ASSERT_EQUAL(137, now.tm_year);
+
+  TEST_ASSERT_FALSE(parseDateTime("2019 12 31 23 59 59", set));
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_output_pin);
+  RUN_TEST(test_clock);
+  RUN_TEST(test_clock_bounds);
+  return UNITY_END();
+}
@@ -0,0 +1,65 @@
+/**
+ * Runs every fuzz target over its seed corpus in test/fuzz/corpus, with
+ * the sanitizers of the native env watching. New findings of a fuzzer go
+ * into the corpus, so they are checked from then on.
+ */
+#include <dirent.h>
+#include <stdio.h>
+#include <string>
+#include <unity.h>
+
+#define FUZZ_CORPUS
+#include "../fuzz/fuzz_expr.cpp"
+#include "../fuzz/fuzz_json.cpp"
+#include "../fuzz/fuzz_parse.cpp"
+#include "../fuzz/fuzz_session.cpp"
+
+using Target = int(*)(const uint8_t* data, size_t size);
+
+/**
+ * Feed every file of the corpus to target, returns the number of files
+ */
+static int replay(const char* corpus, Target target)
+{
+  std::string dir  = std::string(__FILE__).substr(0, std::string(__FILE__).rfind('/')) + "/../fuzz/corpus/" + corpus;
+  DIR*        d    = opendir(dir.c_str());
+  int         runs = 0;
+
+  if (d == nullptr) return 0;
+  while (dirent* entry = readdir(d))
+  {
+    if (entry->d_name[0] == '.') continue;
+
+    std::string path = dir + "/" + entry->d_name;
+    uint8_t     data[FUZZ_LINE];
+    FILE*       in = fopen(path.c_str(), "rb");
+
+    if (in == nullptr) continue;
+    size_t size = fread(data, 1, sizeof(data), in);
+    fclose(in);
+    target(data, size);
+    runs++;
+  }
+  closedir(d);
+  return runs;
+}
+
+
+void setUp() {}
+void tearDown() {}
+
+void test_parse_corpus() { TEST_ASSERT_GREATER_THAN(0, replay("parse", fuzz_parse)); }
+void test_expr_corpus()  { TEST_ASSERT_GREATER_THAN(0, replay("expr", fuzz_expr)); }
+void test_json_corpus()  { TEST_ASSERT_GREATER_THAN(0, replay("json", fuzz_json)); }
+void test_session_corpus() { TEST_ASSERT_GREATER_THAN(0, replay("session", fuzz_session)); }
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_corpus);
+  RUN_TEST(test_expr_corpus);
+  RUN_TEST(test_json_corpus);
+  RUN_TEST(test_session_corpus);
+  return UNITY_END();
+}
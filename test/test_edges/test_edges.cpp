@@ -0,0 +1,123 @@
+/**
+ * The queue between the edge interrupts and the loop, with the interrupts
+ * raised through the handlers attachInterrupt() keeps on the host.
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include "EdgeTrigger.h"
+
+/**
+ * Take all events still queued, returns their number
+ */
+static uint8_t drain()
+{
+  EdgeEvent event;
+  uint8_t   n = 0;
+
+  while (edgePop(event)) n++;
+  return n;
+}
+
+
+void setUp() { drain(); }
+void tearDown() {}
+
+
+void test_order()
+{
+  EdgeEvent event;
+
+  for (uint8_t i = 0; i < EDGE_BINDINGS; i++) edgeInject(i);
+  for (uint8_t i = 0; i < EDGE_BINDINGS; i++)
+  {
+    TEST_ASSERT_TRUE(edgePop(event));
+    TEST_ASSERT_EQUAL(i, event.binding);
+  }
+  TEST_ASSERT_FALSE(edgePop(event));
+}
+
+
+/**
+ * The indexes wrap at 256, which a multiple of EDGE_QUEUE keeps in step
+ */
+void test_wrap()
+{
+  EdgeEvent event;
+  uint32_t  last = 0;
+
+  for (uint16_t i = 0; i < 600; i++)
+  {
+    edgeInject(i % EDGE_BINDINGS);
+    TEST_ASSERT_TRUE(edgePop(event));
+    TEST_ASSERT_EQUAL(i % EDGE_BINDINGS, event.binding);
+    TEST_ASSERT_TRUE(event.micros >= last);
+    last = event.micros;
+  }
+  TEST_ASSERT_FALSE(edgePop(event));
+}
+
+
+/**
+ * A full queue drops the new edges and counts them, the queued ones stay
+ */
+void test_overflow()
+{
+  EdgeEvent event;
+  uint32_t  before = edgeStats().overflows;
+
+  for (uint8_t i = 0; i < EDGE_QUEUE + 3; i++) edgeInject(i % EDGE_BINDINGS);
+  TEST_ASSERT_EQUAL(before + 3, edgeStats().overflows);
+  for (uint8_t i = 0; i < EDGE_QUEUE; i++)
+  {
+    TEST_ASSERT_TRUE(edgePop(event));
+    TEST_ASSERT_EQUAL(i % EDGE_BINDINGS, event.binding);
+  }
+  TEST_ASSERT_FALSE(edgePop(event));
+
+  edgeInject(1);
+  TEST_ASSERT_EQUAL(before + 3, edgeStats().overflows);
+  TEST_ASSERT_EQUAL(1, drain());
+}
+
+
+void test_attach()
+{
+  EdgeEvent event;
+
+  edgeAttach(2, 5, FALLING);
+  edgeAttach(EDGE_BINDINGS, 6, FALLING);   // no such binding, ignored
+  TEST_ASSERT_NOT_NULL(hostInterrupts[5]);
+  TEST_ASSERT_NULL(hostInterrupts[6]);
+
+  uint32_t start = micros();
+  hostInterrupts[5]();
+  TEST_ASSERT_TRUE(edgePop(event));
+  TEST_ASSERT_EQUAL(2, event.binding);
+  TEST_ASSERT_TRUE(event.micros - start < 1000);
+}
+
+
+void test_latency()
+{
+  edgeLatency(10);
+  edgeLatency(30);
+  edgeLatency(20);
+
+  const EdgeStats& stats = edgeStats();
+  TEST_ASSERT_EQUAL(3, stats.count);
+  TEST_ASSERT_EQUAL(10, stats.min);
+  TEST_ASSERT_EQUAL(30, stats.max);
+  TEST_ASSERT_EQUAL(60, stats.total);
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_order);
+  RUN_TEST(test_wrap);
+  RUN_TEST(test_overflow);
+  RUN_TEST(test_attach);
+  RUN_TEST(test_latency);
+  return UNITY_END();
+}
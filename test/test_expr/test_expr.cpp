@@ -0,0 +1,130 @@
+#include <math.h>
+#include <unity.h>
+#include "Cycles.h"
+#include "Expr.h"
+#include "Format.h"
+
+static bool lookup(const char* name, uint8_t len, int32_t& value)
+{
+  if (len != 1) return false;
+  switch (*name)
+  {
+    case 'i': value = 7;         return true;
+    case 'b': value = 123456789; return true;  // not exact as a 32-bit float
+    case 'm': value = INT32_MAX; return true;
+    default:                     return false;
+  }
+}
+
+static bool lookup(const char* name, uint8_t len, double& value)
+{
+  if (len != 1) return false;
+  switch (*name)
+  {
+    case 'i': value = 7;    return true;
+    case 'f': value = 1e20; return true;
+    case 'x': value = NAN;  return true;
+    default:                return false;
+  }
+}
+
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_integer()
+{
+  int32_t v = 0;
+
+  TEST_ASSERT_TRUE(evaluate("(0x40 << 2) + 3 * -7", v));
+  TEST_ASSERT_EQUAL_INT32(235, v);
+  TEST_ASSERT_TRUE(evaluate("(i + 3) * 2", v, lookup));
+  TEST_ASSERT_EQUAL_INT32(20, v);
+  TEST_ASSERT_FALSE(evaluate("1 / 0", v));
+  TEST_ASSERT_FALSE(evaluate("1.5", v));
+}
+
+
+void test_integer_limits()
+{
+  int32_t v = 0;
+
+  TEST_ASSERT_TRUE(evaluate("-2147483648", v));
+  TEST_ASSERT_EQUAL_INT32(INT32_MIN, v);
+  TEST_ASSERT_TRUE(evaluate("1 - -2147483648", v));
+  TEST_ASSERT_EQUAL_INT32(INT32_MIN + 1, v);
+  TEST_ASSERT_TRUE(evaluate("0xFFFFFFFF", v));
+  TEST_ASSERT_EQUAL_INT32(-1, v);
+  TEST_ASSERT_FALSE(evaluate("2147483648", v));
+  TEST_ASSERT_FALSE(evaluate("-(2147483648)", v));
+  TEST_ASSERT_FALSE(evaluate("-2147483649", v));
+}
+
+
+/**
+ * Integer variables are taken with all their bits
+ */
+void test_integer_variable()
+{
+  int32_t v = 0;
+
+  TEST_ASSERT_TRUE(evaluate("b", v, lookup));
+  TEST_ASSERT_EQUAL_INT32(123456789, v);
+  TEST_ASSERT_TRUE(evaluate("m - 1", v, lookup));
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX - 1, v);
+  TEST_ASSERT_TRUE(evaluate("-m - 1", v, lookup));
+  TEST_ASSERT_EQUAL_INT32(INT32_MIN, v);
+}
+
+
+void test_variable_out_of_range()
+{
+  int32_t v = 0;
+  double  d = 0;
+
+  TEST_ASSERT_FALSE(evaluate("f", v, lookup));
+  TEST_ASSERT_FALSE(evaluate("x", d, lookup));
+  TEST_ASSERT_EQUAL_INT32(0, v);
+  TEST_ASSERT_TRUE(evaluate("f / 1e10", d, lookup));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1e10, d);
+}
+
+
+/**
+ * The cost of an evaluation per token. A long expression must not cost 
+ * more per token than a short one, the stacks are scanned only at the top.
+ */
+void test_cost_per_token()
+{
+  const char* shortExpr = "(0x40 << 2) + 3 * -7";                      // 10 tokens
+  const char* longExpr  = "((1 + 2) * (3 + 4) - (5 + 6) * (7 + 8)) / (9 + 10) + 11 * 12 - 13 << 2";  // 39 tokens
+  int32_t     v;
+  char        msg[64];
+  BufferPrint text(msg, sizeof(msg));
+
+  cyclesBegin();
+  uint32_t shortCost = measureCycles(10000, [&] { evaluate(shortExpr, v); });
+  uint32_t longCost  = measureCycles(10000, [&] { evaluate(longExpr, v); });
+  cyclesEnd();
+
+  uint32_t shortToken = shortCost / 10;
+  uint32_t longToken  = longCost / 39;
+  emit(text, "evaluate ", fixed((double)shortToken / cyclesPerMicro() * 1000, 0), " ns/token, long ", 
+       fixed((double)longToken / cyclesPerMicro() * 1000, 0), " ns/token");
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(evaluate(longExpr, v));
+  TEST_ASSERT_LESS_OR_EQUAL(2 * shortToken + 1, longToken);
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_integer);
+  RUN_TEST(test_integer_limits);
+  RUN_TEST(test_integer_variable);
+  RUN_TEST(test_variable_out_of_range);
+  RUN_TEST(test_cost_per_token);
+  return UNITY_END();
+}
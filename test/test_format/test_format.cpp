@@ -0,0 +1,80 @@
+#include <math.h>
+#include <unity.h>
+#include "Format.h"
+
+char        buf[64];
+BufferPrint text(buf, sizeof(buf));
+
+void setUp() { text.clear(); }
+void tearDown() {}
+
+
+void test_hex()
+{
+  emit(text, hex(0xBEEF), ' ', hex(0x1F, 4), ' ', hex(0));
+  TEST_ASSERT_EQUAL_STRING("BEEF 001F 0", buf);
+}
+
+
+void test_hex_digits_clamped()
+{
+  emit(text, hex(0xDEADBEEF, 12), ' ', hex(5, 255));
+  TEST_ASSERT_EQUAL_STRING("DEADBEEF 00000005", buf);
+}
+
+
+void test_width()
+{
+  emit(text, '[', width(42, 5), "][", width(-5, 4, '0'), "][", width(-5, 4), "][", width(7, 3, '0'), ']');
+  TEST_ASSERT_EQUAL_STRING("[   42][-005][  -5][007]", buf);
+}
+
+
+void test_width_overflow()
+{
+  emit(text, width(-12345, 3, '0'), ' ', width("abc", 2));
+  TEST_ASSERT_EQUAL_STRING("-12345 abc", buf);
+}
+
+
+/**
+ * The Print of the native env shows ovf beyond a uint32_t like the cores,
+ * fixed() must not
+ */
+void test_fixed()
+{
+  emit(text, fixed(3.14159, 2), ' ', fixed(-0.5, 1), ' ', fixed(2.5, 0), ' ', fixed(0.001, 3), ' ', fixed(9.9999, 2));
+  TEST_ASSERT_EQUAL_STRING("3.14 -0.5 3 0.001 10.00", buf);
+}
+
+
+void test_fixed_beyond_uint32()
+{
+  text.print(1e10, 2);
+  TEST_ASSERT_EQUAL_STRING("ovf", buf);
+
+  text.clear();
+  emit(text, fixed(1e10, 2), ' ', fixed(-1.5e12, 3), ' ', fixed(4294967295.0, 1), ' ', fixed(9.9999e20, 2));
+  TEST_ASSERT_EQUAL_STRING("1.00e10 -1.500e12 4294967295.0 1.00e21", buf);
+}
+
+
+void test_fixed_not_finite()
+{
+  emit(text, fixed(NAN, 2), ' ', fixed(-INFINITY, 2), ' ', 2.5e10, ' ', 1.25f);
+  TEST_ASSERT_EQUAL_STRING("nan -inf 2.50e10 1.25", buf);
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_hex);
+  RUN_TEST(test_hex_digits_clamped);
+  RUN_TEST(test_width);
+  RUN_TEST(test_width_overflow);
+  RUN_TEST(test_fixed);
+  RUN_TEST(test_fixed_beyond_uint32);
+  RUN_TEST(test_fixed_not_finite);
+  return UNITY_END();
+}
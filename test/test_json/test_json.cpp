@@ -0,0 +1,94 @@
+/**
+ * Replies of the JSON lines mode and the rate at which requests are served
+ */
+#include <unity.h>
+#include "Cycles.h"
+#include "Format.h"
+#include "JsonLine.h"
+#include "Menu.h"
+
+NullPrint  sink;
+JsonResult result;
+
+void sayHello(const char* txt) { emit(sink, txt, ' '); }
+
+void enterFloat(const char* txt)
+{
+  result.type = JsonResult::Float;
+  result.f    = 1e10;
+  emit(sink, fixed(result.f, 6), " was entered ");
+}
+
+constexpr MenuItem items[] = 
+{
+  { 'h', "[h] Say Hello",   "Guten Tag", sayHello },
+  { 'f', "[f] Enter a float", "",        enterFloat },
+};
+constexpr Menu<2> menu(items);
+
+/**
+ * Serve one request as onJsonRequest() does, the output going nowhere
+ */
+static void serve(const char* line)
+{
+  char        buf[64];
+  char        cmd;
+  const char* arg;
+
+  strcpy(buf, line);
+  result.type = JsonResult::None;
+  if (! parseJsonRequest(buf, cmd, arg)) return;
+  menu.dispatch(cmd);
+  emit(sink, "{\"cmd\":\"", cmd, "\",\"text\":\"\",\"ok\":true");
+  printJsonValue(sink, result);
+  sink.print("}\r\n");
+}
+
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_values()
+{
+  char        buf[64];
+  BufferPrint text(buf, sizeof(buf));
+  JsonResult  r;
+
+  r.type = JsonResult::Float;
+  r.f    = 1e10;
+  printJsonValue(text, r);
+  r.f    = -2.5;
+  printJsonValue(text, r);
+  r.type = JsonResult::Integer;
+  r.i    = INT32_MIN;
+  printJsonValue(text, r);
+  TEST_ASSERT_EQUAL_STRING(",\"value\":1.000000e10,\"value\":-2.500000,\"value\":-2147483648", buf);
+}
+
+
+void test_request_rate()
+{
+  char        msg[64];
+  BufferPrint text(msg, sizeof(msg));
+
+  cyclesBegin();
+  uint32_t hello = measureCycles(10000, [] { serve("{\"cmd\":\"h\"}"); });
+  uint32_t value = measureCycles(10000, [] { serve("{\"cmd\":\"f\",\"arg\":\"1e10\"}"); });
+  cyclesEnd();
+
+  uint32_t helloRate = (uint64_t)cyclesPerMicro() * 1000000 / (hello ? hello : 1);
+  uint32_t valueRate = (uint64_t)cyclesPerMicro() * 1000000 / (value ? value : 1);
+  emit(text, "json ", helloRate, " requests/s, with value ", valueRate, " requests/s");
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_GREATER_THAN(10000, valueRate);
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_values);
+  RUN_TEST(test_request_rate);
+  return UNITY_END();
+}
@@ -0,0 +1,64 @@
+#include <unity.h>
+#include "CliParse.h"
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_leap_day()
+{
+  tm t;
+
+  TEST_ASSERT_TRUE(parseDateTime("2024 02 29 12 00 00", t));
+  TEST_ASSERT_EQUAL(29, t.tm_mday);
+  TEST_ASSERT_TRUE(parseDateTime("2036 02 29 12 00 00", t));
+  TEST_ASSERT_FALSE(parseDateTime("2023 02 29 10 00 00", t));
+  TEST_ASSERT_FALSE(parseDateTime("2025 02 29 10 00 00", t));
+  TEST_ASSERT_FALSE(parseDateTime("2024 04 31 10 00 00", t));
+}
+
+
+void test_date_range()
+{
+  tm t;
+
+  TEST_ASSERT_FALSE(parseDateTime("2019 12 31 23 59 59", t));
+  TEST_ASSERT_TRUE(parseDateTime("2020 01 01 00 00 00", t));
+  TEST_ASSERT_TRUE(parseDateTime("2037 12 31 23 59 59", t));
+  TEST_ASSERT_FALSE(parseDateTime("2038 01 01 00 00 00", t));
+}
+
+
+void test_integer_range()
+{
+  int32_t v = 0;
+
+  TEST_ASSERT_TRUE(parseInteger("-2147483648", v));
+  TEST_ASSERT_EQUAL_INT32(INT32_MIN, v);
+  TEST_ASSERT_FALSE(parseInteger("2147483648", v));
+  TEST_ASSERT_FALSE(parseInteger("12abc", v));
+}
+
+
+void test_range()
+{
+  uint32_t start, length;
+
+  TEST_ASSERT_TRUE(parseRange("0x3FFB0000 256", start, length));
+  TEST_ASSERT_EQUAL_UINT32(0x3FFB0000, start);
+  TEST_ASSERT_EQUAL_UINT32(256, length);
+  TEST_ASSERT_TRUE(parseRange("0xFFFFFFFF 1", start, length));
+  TEST_ASSERT_FALSE(parseRange("0xFFFFFFFF 2", start, length));
+  TEST_ASSERT_FALSE(parseRange("0x100 -1", start, length));
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_leap_day);
+  RUN_TEST(test_date_range);
+  RUN_TEST(test_integer_range);
+  RUN_TEST(test_range);
+  return UNITY_END();
+}
@@ -0,0 +1,162 @@
+/**
+ * Eight sessions served side by side by one loop, as main.cpp does with
+ * the serial session and the telnet clients.
+ */
+#include <string>
+#include <unity.h>
+#include "Format.h"
+#include "Loopback.h"
+#include "Session.h"
+
+constexpr uint8_t SESSIONS = 8;
+
+Loopback    io[SESSIONS];
+Session     sessions[SESSIONS];
+Session*    session;                   // the one being served, as in main.cpp
+std::string answers[SESSIONS];
+
+static void onValue(const char* line)
+{
+  answers[session - sessions] = line;
+}
+
+
+/**
+ * One pass of the loop: every session handles at most one key or line
+ */
+static void serve()
+{
+  for (uint8_t i = 0; i < SESSIONS; i++)
+  {
+    session = &sessions[i];
+    int key = session->step();
+    if (key == 'v') session->ask("value? ", onValue);
+    session->pump();
+    io[i].tick();
+  }
+}
+
+
+void setUp()
+{
+  for (uint8_t i = 0; i < SESSIONS; i++)
+  {
+    io[i] = Loopback();
+    sessions[i].attach(&io[i]);
+    answers[i].clear();
+  }
+}
+
+void tearDown() {}
+
+
+/**
+ * All clients type their values at the same time, one key per pass each
+ */
+void test_interleaved_input()
+{
+  std::string values[SESSIONS];
+  size_t      longest = 0;
+
+  for (uint8_t i = 0; i < SESSIONS; i++)
+  {
+    char        buf[16];
+    BufferPrint text(buf, sizeof(buf));
+
+    emit(text, "value ", i * 111);
+    values[i] = buf;
+    if (values[i].size() > longest) longest = values[i].size();
+    io[i].send("v");
+  }
+  serve();
+  for (size_t k = 0; k <= longest; k++)
+  {
+    for (uint8_t i = 0; i < SESSIONS; i++)
+    {
+      const char key[] = { k < values[i].size() ? values[i][k] : '\r', '\0' };
+      io[i].send(key);
+    }
+    serve();
+  }
+  for (uint8_t i = 0; i < SESSIONS; i++)
+  {
+    TEST_ASSERT_EQUAL_STRING(values[i].c_str(), answers[i].c_str());
+    TEST_ASSERT_EQUAL_STRING(("value? " + values[i] + "\r\n").c_str(), io[i].received.c_str());
+    TEST_ASSERT_FALSE(sessions[i].asking());
+  }
+}
+
+
+/**
+ * A session sending a long output over a slow transport holds up nobody
+ */
+void test_slow_session()
+{
+  io[0] = Loopback(128, 11);
+  sessions[0].attach(&io[0]);
+  for (uint16_t n = 0; n < OUT_SIZE; n++) sessions[0].write('x');
+
+  for (uint8_t i = 1; i < SESSIONS; i++) io[i].send("v42\r");
+  for (uint8_t pass = 0; pass < 3; pass++) serve();
+
+  for (uint8_t i = 1; i < SESSIONS; i++) TEST_ASSERT_EQUAL_STRING("42", answers[i].c_str());
+  TEST_ASSERT_EQUAL_UINT32(0, io[0].blocked);
+  TEST_ASSERT_TRUE(io[0].received.size() < OUT_SIZE);
+}
+
+
+/**
+ * Ctrl-C drops a partial JSON request, the next request is still taken
+ */
+void test_json_ctrl_c()
+{
+  session = &sessions[0];
+  session->setJson(true);
+  session->ask("", onValue);
+  io[0].send("{\"cmd\":\x03{\"cmd\":\"h\"}\n");
+  while (session->step() >= 0 || io[0].available()) {}
+
+  TEST_ASSERT_EQUAL_STRING("{\"cmd\":\"h\"}", answers[0].c_str());
+  TEST_ASSERT_EQUAL_STRING("", io[0].received.c_str());
+}
+
+
+/**
+ * A client taking over a session slot finds none of the modes of the last one
+ */
+void test_attach_resets()
+{
+  Loopback discard;
+
+  session = &sessions[0];
+  session->setJson(true);
+  session->setEscape(true);
+  session->setFlowControl(true);
+  session->redirect(&discard);
+  session->setTap(onValue);
+  session->ask("", onValue, onValue);
+
+  session->attach(&io[0]);
+  TEST_ASSERT_FALSE(session->jsonMode());
+  TEST_ASSERT_FALSE(session->flowControl());
+  TEST_ASSERT_FALSE(session->asking());
+  TEST_ASSERT_FALSE(session->pager.active());
+  TEST_ASSERT_FALSE(session->status.active());
+
+  io[0].send("v\"x\"\r");
+  serve();
+  serve();
+  TEST_ASSERT_EQUAL_STRING("value? \"x\"\r\n", io[0].received.c_str());
+  TEST_ASSERT_EQUAL_STRING("", discard.received.c_str());
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_interleaved_input);
+  RUN_TEST(test_slow_session);
+  RUN_TEST(test_json_ctrl_c);
+  RUN_TEST(test_attach_resets);
+  return UNITY_END();
+}
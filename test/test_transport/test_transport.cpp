@@ -0,0 +1,160 @@
+/**
+ * Output throughput of a session over a UART, modelled by a Loopback 
+ * ticking once per loop pass of 1 ms, and over a real socket of the host.
+ * The telnet negotiation is taken from the socket in arbitrary pieces.
+ */
+#include <string>
+#include <sys/socket.h>
+#include <unity.h>
+#include "Format.h"
+#include "Loopback.h"
+#include "Session.h"
+#include "SocketStream.h"
+#include "TelnetFilter.h"
+
+constexpr size_t TOTAL = 16384;   // bytes an action outputs
+
+/**
+ * Let the action write TOTAL bytes as the loop would, pumping the session
+ * once per pass. deliver() passes the time of one pass on the transport
+ * and returns what arrived at the other end so far. Returns the passes.
+ */
+template<typename F>
+static uint32_t throughput(Stream& io, F deliver)
+{
+  Session     session;
+  std::string sent;
+  uint32_t    n = 0;
+  uint32_t    passes = 0;
+
+  session.attach(&io);
+  for (;;)
+  {
+    // write no more than the queue takes, so only pump() talks to the transport
+    int room = session.availableForWrite();
+    while (room-- > 0 && sent.size() < TOTAL)
+    {
+      char c = 'a' + n++ % 26;
+      session.write(c);
+      sent += c;
+    }
+    session.pump();
+    passes++;
+
+    const std::string& received = deliver();
+    if (received.size() >= TOTAL)
+    {
+      TEST_ASSERT_TRUE(received == sent);
+      return passes;
+    }
+  }
+}
+
+
+void setUp() {}
+void tearDown() {}
+
+
+/**
+ * At 115200 baud the UART drains 11.5 bytes per ms from a FIFO of 128, 
+ * the session must not lose time by blocking on it
+ */
+void test_uart()
+{
+  Loopback    uart(128, 11);
+  uint32_t    passes = throughput(uart, [&]() -> const std::string& { uart.tick(); return uart.received; });
+  uint32_t    rate   = TOTAL * 1000 / passes;
+  char        msg[64];
+  BufferPrint text(msg, sizeof(msg));
+
+  emit(text, "uart ", rate, " bytes/s modelled");
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, uart.blocked);
+  TEST_ASSERT_UINT32_WITHIN(500, 11500, rate);
+}
+
+
+/**
+ * A socket with the send buffer of lwIP, read by the peer once per pass.
+ * The session sends its whole queue per pass, the socket is no limit.
+ */
+void test_socket()
+{
+  int fds[2];
+  int buffer = 5744;   // four segments
+
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+
+  SocketStream client(fds[0]);
+  std::string  received;
+  uint32_t     start  = micros();
+  uint32_t     passes = throughput(client, [&]() -> const std::string&
+  {
+    char    buf[4096];
+    ssize_t n;
+    while ((n = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0) received.append(buf, n);
+    return received;
+  });
+  uint32_t     us = micros() - start;
+  close(fds[0]);
+  close(fds[1]);
+
+  char        msg[96];
+  BufferPrint text(msg, sizeof(msg));
+
+  emit(text, "socket ", (uint64_t)TOTAL * 1000000 / (us ? us : 1), " bytes/s, ", TOTAL / passes, 
+       " bytes per pass, ", client.shortWrites, " short writes");
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(TOTAL / OUT_SIZE, passes);
+}
+
+
+/**
+ * Commands split between the pieces the client sends are still stripped,
+ * the option SGA (3) after WILL must not come through as Ctrl-C
+ */
+void test_telnet_split()
+{
+  using T = TelnetFilter;
+  const std::string pieces[] =
+  {
+    { (char)T::IAC },
+    { (char)T::WILL },
+    { (char)T::OPT_SGA, 'a' },
+    { (char)T::IAC, (char)T::IAC },
+    { (char)T::IAC, (char)T::SB, 24, 0, 'x', (char)T::IAC },
+    { (char)T::SE, 'b', (char)T::IAC, (char)T::DO },
+    { (char)T::OPT_ECHO, '\r' },
+  };
+  int fds[2];
+
+  TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  SocketStream client(fds[0]);
+  TelnetFilter filter;
+  std::string  data;
+
+  for (const std::string& piece : pieces)
+  {
+    send(fds[1], piece.data(), piece.size(), 0);
+    while (client.available())
+    {
+      int c = filter.take(client.read());
+      if (c >= 0) data += (char)c;
+    }
+  }
+  close(fds[0]);
+  close(fds[1]);
+  TEST_ASSERT_TRUE(data == std::string("a\xff" "b\r"));
+}
+
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_uart);
+  RUN_TEST(test_socket);
+  RUN_TEST(test_telnet_split);
+  return UNITY_END();
+}
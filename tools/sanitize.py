@@ -0,0 +1,5 @@
+# Links the native env with the sanitizers it is compiled with, 
+# build_flags only reach the compiler.
+Import("env")
+
+env.Append(LINKFLAGS=["-fsanitize=address,undefined", "-fno-sanitize-recover=all"])
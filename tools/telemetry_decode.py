@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Decode the binary telemetry stream of the CLI menu ([B] command).
+
+Reads from a serial port (needs pyserial) or from a captured file, checks
+sync, CRC and sequence numbers and prints the frames, the frame and byte
+rate and the counts of lost and corrupted frames.
+
+  python tools/telemetry_decode.py /dev/ttyUSB0 --baud 115200
+  python tools/telemetry_decode.py capture.bin --quiet
+"""
+import argparse
+import struct
+import sys
+import time
+
+CHANNELS = 4                                     # TELEMETRY_CHANNELS
+FRAME    = struct.Struct("<2sHI%dhH" % CHANNELS)  # TelemetryFrame
+SYNC     = b"\xa5\x5a"
+
+
+def crc16(data, crc=0):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def open_source(name, baud):
+    """Returns the stream and whether it ends, which a serial port doesn't"""
+    try:
+        import serial
+        return serial.Serial(name, baud, timeout=0.1), False
+    except (ImportError, ValueError, OSError):
+        return open(name, "rb"), True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("source", help="serial port or capture file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--quiet", action="store_true", help="print the summary only")
+    args = parser.parse_args()
+
+    src, finite = open_source(args.source, args.baud)
+    buf = b""
+    frames = lost = corrupt = nbytes = 0
+    last_seq = first_us = last_us = None
+    start = time.monotonic()
+    try:
+        while True:
+            data = src.read(4096)
+            if not data:
+                if finite:
+                    break
+                continue
+            nbytes += len(data)
+            buf += data
+            while True:
+                i = buf.find(SYNC)
+                if i < 0:
+                    buf = buf[-1:]
+                    break
+                if len(buf) - i < FRAME.size:
+                    buf = buf[i:]
+                    break
+                raw = buf[i:i + FRAME.size]
+                _, seq, us, *rest = FRAME.unpack(raw)
+                channels, crc = rest[:-1], rest[-1]
+                if crc16(raw[2:-2]) != crc:
+                    corrupt += 1
+                    buf = buf[i + 1:]   # resync after the false sync
+                    continue
+                buf = buf[i + FRAME.size:]
+                if last_seq is not None:
+                    lost += (seq - last_seq - 1) & 0xFFFF
+                last_seq = seq
+                first_us = us if first_us is None else first_us
+                last_us = us
+                frames += 1
+                if not args.quiet:
+                    print("%5u %10u %s" % (seq, us, " ".join("%5d" % c for c in channels)))
+    except KeyboardInterrupt:
+        pass
+
+    # the rate follows from the timestamps of the board, so a capture file gives it too
+    seconds = ((last_us - first_us) & 0xFFFFFFFF) / 1e6 if frames > 1 else 0
+    if seconds == 0:
+        seconds = max(time.monotonic() - start, 1e-6)
+    print("%d frames, %d lost, %d corrupt in %.2f s: %.1f frames/s, %.0f bytes/s of frames"
+          % (frames, lost, corrupt, seconds, (frames + lost) / seconds, frames * FRAME.size / seconds),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()